@@ -504,6 +504,9 @@ Amr::InitAmr ()
     loadbalance_with_workestimates = 0;
     pp.query("loadbalance_with_workestimates", loadbalance_with_workestimates);
 
+    loadbalance_with_measured_costs = 0;
+    pp.query("loadbalance_with_measured_costs", loadbalance_with_measured_costs);
+
     loadbalance_level0_int = 2;
     pp.query("loadbalance_level0_int", loadbalance_level0_int);
 
@@ -2001,6 +2004,13 @@ Amr::timeStep (int  level,
                 level_count[0] = 0;
             }
         }
+        else if (max_level == 0 && loadbalance_level0_int > 0 && loadbalance_with_measured_costs)
+        {
+            if (level_count[0] >= loadbalance_level0_int) {
+                LoadBalanceLevel0(time);
+                level_count[0] = 0;
+            }
+        }
     }
     //
     // Check to see if should write plotfile.
@@ -2021,7 +2031,15 @@ Amr::timeStep (int  level,
                        << " with dt = " << dt_level[level] << "\n";
     }
 
+    if (loadbalance_with_measured_costs) {
+        GetLoadBalancer(level).startTiming();
+    }
+
     Real dt_new = amr_level[level]->advance(time,dt_level[level],iteration,niter);
+
+    if (loadbalance_with_measured_costs) {
+        GetLoadBalancer(level).stopTiming();
+    }
     BL_PROFILE_REGION_STOP("amr_level.advance");
 
     dt_min[level] = iteration == 1 ? dt_new : std::min(dt_min[level],dt_new);
@@ -2598,10 +2616,17 @@ Amr::regrid (int  lbase,
     const int start = regrid_level_zero ? 0 : lbase+1;
 
     bool grids_unchanged = finest_level == new_finest;
+    Vector<int> rebalanced(max_level+1, false);
     for (int lev = start, End = std::min(finest_level,new_finest); lev <= End; lev++) {
         if (new_grid_places[lev] == amr_level[lev]->boxArray()) {
             new_grid_places[lev] = amr_level[lev]->boxArray();  // to avoid duplicates
             new_dmap[lev] = amr_level[lev]->DistributionMap();
+            if (loadbalance_with_measured_costs && !initial && !loadbalance_with_workestimates
+                && RebalanceDistributionMap(lev, new_grid_places[lev], new_dmap[lev]))
+            {
+                rebalanced[lev] = true;
+                grids_unchanged = false;
+            }
         } else {
             grids_unchanged = false;
         }
@@ -2635,6 +2660,9 @@ Amr::regrid (int  lbase,
         amr_level[lev].reset();
         this->ClearBoxArray(lev);
         this->ClearDistributionMap(lev);
+        if (lev < static_cast<int>(m_load_balancer.size())) {
+            m_load_balancer[lev].reset();
+        }
     }
 
     finest_level = new_finest;
@@ -2651,9 +2679,23 @@ Amr::regrid (int  lbase,
             new_dmap[lev] = makeLoadBalanceDistributionMap(lev, time, new_grid_places[lev]);
         }
         else if (new_dmap[lev].empty()) {
-            new_dmap[lev].define(new_grid_places[lev]);
+            // Only the distribution map is kept here. The AmrLevel made by
+            // levelbld allocates new state data, and AmrLevel::init fills
+            // all of it, so no FAB is reused as in RemakeFabArray.
+            if (incremental_regrid && !initial && amr_level[lev]) {
+                new_dmap[lev] = RemakeDistributionMap(lev, new_grid_places[lev],
+                                                      amr_level[lev]->boxArray(),
+                                                      amr_level[lev]->DistributionMap());
+            } else {
+                new_dmap[lev].define(new_grid_places[lev]);
+            }
+            if (loadbalance_with_measured_costs && !initial && amr_level[lev]) {
+                RebalanceDistributionMap(lev, new_grid_places[lev], new_dmap[lev]);
+            }
         }
 
+        const double t_rebuild = amrex::second();
+
         AmrLevel* a = (*levelbld)(*this,lev,Geom(lev),new_grid_places[lev],
                                   new_dmap[lev],cumtime);
 
@@ -2680,6 +2722,10 @@ Amr::regrid (int  lbase,
             amr_level[lev].reset(a);
             this->SetBoxArray(lev, amr_level[lev]->boxArray());
             this->SetDistributionMap(lev, amr_level[lev]->DistributionMap());
+            if (rebalanced[lev]) {
+                GetLoadBalancer(lev).setRedistributionTime(
+                    static_cast<Real>(amrex::second()-t_rebuild));
+            }
         }
         else
         {
@@ -2799,6 +2845,19 @@ void
 Amr::LoadBalanceLevel0 (Real time)
 {
     BL_PROFILE("LoadBalanceLevel0()");
+    if (loadbalance_with_measured_costs && !loadbalance_with_workestimates) {
+        DistributionMapping dm = DistributionMap(0);
+        if (RebalanceDistributionMap(0, boxArray(0), dm)) {
+            if (verbose) {
+                amrex::Print() << "Load balance on level 0 at t = " << time << "\n";
+            }
+            const double t0 = amrex::second();
+            InstallNewDistributionMap(0, dm);
+            amr_level[0]->post_regrid(0,0);
+            GetLoadBalancer(0).setRedistributionTime(static_cast<Real>(amrex::second()-t0));
+        }
+        return;
+    }
     const auto& dm = makeLoadBalanceDistributionMap(0, time, boxArray(0));
     InstallNewDistributionMap(0, dm);
     amr_level[0]->post_regrid(0,0);
@@ -1,5 +1,7 @@
 
 #include <AMReX_AmrCore.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
 
 #ifdef AMREX_PARTICLES
 #include <AMReX_AmrParGDB.H>
@@ -46,7 +48,8 @@ AmrCore::AmrCore (Geometry const& level_0_geom, AmrInfo const& amr_info)
 }
 
 AmrCore::AmrCore (AmrCore&& rhs) noexcept
-    : AmrMesh(static_cast<AmrMesh&&>(rhs))
+    : AmrMesh(static_cast<AmrMesh&&>(rhs)),
+      m_load_balancer(std::move(rhs.m_load_balancer))
 {
 #ifdef AMREX_PARTICLES
     m_gdb = std::move(rhs.m_gdb); // NOLINT(cppcoreguidelines-prefer-member-initializer)
@@ -59,6 +62,7 @@ AmrCore::~AmrCore () {} // NOLINT
 AmrCore& AmrCore::operator= (AmrCore&& rhs) noexcept
 {
     AmrMesh::operator=(static_cast<AmrMesh&&>(rhs));
+    m_load_balancer = std::move(rhs.m_load_balancer);
 #ifdef AMREX_PARTICLES
     m_gdb = std::move(rhs.m_gdb);
     m_gdb->m_amrcore = this;
@@ -98,12 +102,17 @@ AmrCore::regrid (int lbase, Real time, bool)
         if (lev <= finest_level) // an old level
         {
             bool ba_changed = (new_grids[lev] != grids[lev]);
-            if (ba_changed || coarse_ba_changed) {
+            if (!ba_changed && LoadBalance(lev, time)) {
+                // The level has been remade on the new distribution map.
+            } else if (ba_changed || coarse_ba_changed) {
                 BoxArray level_grids = grids[lev];
                 DistributionMapping level_dmap = dmap[lev];
                 if (ba_changed) {
                     level_grids = new_grids[lev];
-                    level_dmap = MakeDistributionMap(lev, level_grids);
+                    level_dmap = incremental_regrid
+                        ? RemakeDistributionMap(lev, level_grids, grids[lev], dmap[lev])
+                        : MakeDistributionMap(lev, level_grids);
+                    RebalanceDistributionMap(lev, level_grids, level_dmap);
                 }
                 const auto old_num_setdm = num_setdm;
                 RemakeLevel(lev, time, level_grids, level_dmap);
@@ -130,11 +139,67 @@ AmrCore::regrid (int lbase, Real time, bool)
         ClearLevel(lev);
         ClearBoxArray(lev);
         ClearDistributionMap(lev);
+        if (lev < static_cast<int>(m_load_balancer.size())) {
+            m_load_balancer[lev].reset();
+        }
     }
 
     finest_level = new_finest;
 }
 
+LoadBalancer&
+AmrCore::GetLoadBalancer (int lev)
+{
+    AMREX_ALWAYS_ASSERT(LevelDefined(lev));
+    if (lev >= static_cast<int>(m_load_balancer.size())) {
+        m_load_balancer.resize(max_level+1);
+    }
+    if (m_load_balancer[lev]) {
+        m_load_balancer[lev]->define(grids[lev], dmap[lev]);
+    } else {
+        m_load_balancer[lev] = std::make_unique<LoadBalancer>(grids[lev], dmap[lev]);
+    }
+    return *m_load_balancer[lev];
+}
+
+bool
+AmrCore::RebalanceDistributionMap (int lev, const BoxArray& ba, DistributionMapping& dm)
+{
+    if (lev >= static_cast<int>(m_load_balancer.size()) || !m_load_balancer[lev]
+        || !m_load_balancer[lev]->hasCosts()) {
+        return false;
+    }
+
+    auto& lb = *m_load_balancer[lev];
+    lb.define(ba, dm);
+    DistributionMapping new_dm;
+    if (!lb.rebalance(new_dm)) { return false; }
+    dm = std::move(new_dm);
+    return true;
+}
+
+bool
+AmrCore::LoadBalance (int lev, Real time)
+{
+    if (!LevelDefined(lev)) { return false; }
+
+    DistributionMapping new_dmap = dmap[lev];
+    if (!RebalanceDistributionMap(lev, grids[lev], new_dmap)) { return false; }
+
+    if (verbose) {
+        amrex::Print() << "Load balance on level " << lev << " at t = " << time << "\n";
+    }
+
+    const double t0 = amrex::second();
+    const auto old_num_setdm = num_setdm;
+    RemakeLevel(lev, time, grids[lev], new_dmap);
+    if (old_num_setdm == num_setdm) {
+        SetDistributionMap(lev, new_dmap);
+    }
+    m_load_balancer[lev]->setRedistributionTime(static_cast<Real>(amrex::second()-t0));
+
+    return true;
+}
 
 void
 AmrCore::printGridSummary (std::ostream& os, int min_lev, int max_lev) const noexcept
@@ -11,7 +11,12 @@
 #include <AMReX_Bittree.H>
 #endif
 
+#include <algorithm>
+#include <functional>
+#include <map>
 #include <memory>
+#include <numeric>
+#include <queue>
 
 namespace amrex {
 
@@ -104,6 +109,8 @@ AmrMesh::InitAmrMesh (int max_level_in, const Vector<int>& n_cell_in,
 
     pp.queryAdd("n_proper",n_proper);
     pp.queryAdd("grid_eff",grid_eff);
+    pp.queryAdd("use_distributed_cluster",use_distributed_cluster);
+    pp.queryAdd("incremental_regrid",incremental_regrid);
     int cnt = pp.countval("n_error_buf");
     if (cnt > 0) {
         Vector<int> neb;
@@ -463,6 +470,78 @@ AmrMesh::MakeDistributionMap (int lev, BoxArray const& ba)
     }
 }
 
+DistributionMapping
+AmrMesh::RemakeDistributionMap (int lev, BoxArray const& ba, BoxArray const& old_ba,
+                                DistributionMapping const& old_dm)
+{
+    BL_PROFILE("AmrMesh::RemakeDistributionMap()");
+
+    const int nprocs = ParallelDescriptor::NProcs();
+    const auto nboxes = static_cast<int>(ba.size());
+
+    std::map<Box,int> old_boxes;
+    for (int i = 0, N = static_cast<int>(old_ba.size()); i < N; ++i) {
+        old_boxes.emplace(old_ba[i], i);
+    }
+
+    Vector<int> pmap(nboxes, -1);
+    Vector<Long> load(nprocs, 0);
+    Vector<std::pair<Long,int>> new_boxes;
+    Long max_box = 0;
+    for (int i = 0; i < nboxes; ++i) {
+        const Box& bx = ba[i];
+        const Long npts = bx.numPts();
+        max_box = std::max(max_box, npts);
+        auto it = old_boxes.find(bx);
+        if (it != old_boxes.end()) {
+            pmap[i] = old_dm[it->second];
+            load[pmap[i]] += npts;
+        } else {
+            new_boxes.emplace_back(npts, i);
+        }
+    }
+
+    if (static_cast<int>(new_boxes.size()) == nboxes) {
+        return MakeDistributionMap(lev, ba);
+    }
+
+    std::sort(new_boxes.begin(), new_boxes.end(),
+              [] (auto const& a, auto const& b) {
+                  return (a.first > b.first) || (a.first == b.first && a.second < b.second);
+              });
+
+    using LoadRank = std::pair<Long,int>;
+    std::priority_queue<LoadRank,Vector<LoadRank>,std::greater<>> pq;
+    for (int iproc = 0; iproc < nprocs; ++iproc) {
+        pq.emplace(load[iproc], iproc);
+    }
+    for (auto const& [npts, i] : new_boxes) {
+        auto [l, iproc] = pq.top();
+        pq.pop();
+        pmap[i] = iproc;
+        load[iproc] = l + npts;
+        pq.emplace(load[iproc], iproc);
+    }
+
+    const Long total = std::accumulate(load.begin(), load.end(), Long(0));
+    const Long max_load = *std::max_element(load.begin(), load.end());
+    const Real target = std::max(Real(total)/Real(nprocs), Real(max_box));
+    if (Real(max_load) > Real(1.5)*target) {
+        if (verbose) {
+            amrex::Print() << "Load imbalance too large for keeping the old grids on level "
+                           << lev << "\n";
+        }
+        return MakeDistributionMap(lev, ba);
+    }
+
+    if (verbose) {
+        amrex::Print() << "Keeping " << nboxes - static_cast<int>(new_boxes.size())
+                       << " old grids on level " << lev << "\n";
+    }
+
+    return DistributionMapping(std::move(pmap));
+}
+
 void
 AmrMesh::ChopGrids (int lev, BoxArray& ba, int target_size) const
 {
@@ -733,10 +812,18 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
         // Create initial cluster containing all tagged points.
         //
         Gpu::PinnedVector<IntVect> tagvec;
-        tags.collate(tagvec);
+        Long ntags;
+        if (use_distributed_cluster) {
+            tags.local_collate(tagvec);
+            ntags = static_cast<Long>(tagvec.size());
+            ParallelDescriptor::ReduceLongSum(ntags);
+        } else {
+            tags.collate(tagvec);
+            ntags = static_cast<Long>(tagvec.size());
+        }
         tags.clear();
 
-        if (!tagvec.empty())
+        if (ntags > 0)
         {
             //
             // Created new level, now generate efficient grids.
@@ -747,7 +834,34 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
 
             if (levf > useFixedUpToLevel()) {
                 BoxList new_bx;
-                if (ParallelDescriptor::IOProcessor()) {
+                if (use_distributed_cluster) {
+                    BL_PROFILE("AmrMesh-cluster");
+                    //
+                    // Cluster the tags on this process, and then merge
+                    // the clusters of all processes on the I/O processor.
+                    //
+                    if (!tagvec.empty()) {
+                        ClusterList clist(tagvec.data(), static_cast<Long>(tagvec.size()));
+                        if (use_new_chop) {
+                            clist.new_chop(grid_eff);
+                        } else {
+                            clist.chop(grid_eff);
+                        }
+                        clist.intersect(p_n_ba[levc]);
+                        clist.boxList(new_bx);
+                    }
+                    new_bx = TreeMergeBoxLists(std::move(new_bx));
+
+                    if (ParallelDescriptor::IOProcessor()) {
+                        new_bx.refine(bf_lev[levc]);
+                        new_bx.simplify();
+
+                        if (new_bx.size()>0) {
+                            // Chop new grids outside domain
+                            new_bx.intersect(Geom(levc).Domain());
+                        }
+                    }
+                } else if (ParallelDescriptor::IOProcessor()) {
                     BL_PROFILE("AmrMesh-cluster");
                     //
                     // Construct initial cluster.
@@ -1256,6 +1370,8 @@ std::ostream& operator<< (std::ostream& os, AmrMesh const& amr_mesh)
     os << "  refine_grid_layout_dims = " << amr_mesh.refine_grid_layout_dims << "\n";
     os << "  check_input = " << amr_mesh.check_input  << "\n";
     os << "  use_new_chop = " << amr_mesh.use_new_chop << "\n";
+    os << "  use_distributed_cluster = " << amr_mesh.use_distributed_cluster << "\n";
+    os << "  incremental_regrid = " << amr_mesh.incremental_regrid << "\n";
     os << "  iterate_on_new_grids = " << amr_mesh.iterate_on_new_grids << "\n";
     return os;
 }
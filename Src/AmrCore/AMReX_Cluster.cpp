@@ -5,6 +5,7 @@
 #include <AMReX_Vector.H>
 #include <AMReX_Array.H>
 #include <AMReX_BLProfiler.H>
+#include <AMReX_ParallelDescriptor.H>
 
 #include <algorithm>
 #include <cmath>
@@ -576,4 +577,59 @@ ClusterList::intersect (BoxArray& domba)
     domba.clear();
 }
 
+BoxList
+TreeMergeBoxLists (BoxList bl)
+{
+    BL_PROFILE("TreeMergeBoxLists()");
+
+#ifdef BL_USE_MPI
+    const int nprocs = ParallelDescriptor::NProcs();
+    const int ioproc = ParallelDescriptor::IOProcessorNumber();
+    // Rank in the tree whose root is the I/O processor
+    const int rank = (ParallelDescriptor::MyProc() - ioproc + nprocs) % nprocs;
+    const int seqno = ParallelDescriptor::SeqNum();
+
+    for (int step = 1; step < nprocs; step *= 2)
+    {
+        if (rank % (2*step) != 0)
+        {
+            const int dst = (rank - step + ioproc) % nprocs;
+            int nboxes = static_cast<int>(bl.size());
+            ParallelDescriptor::Send(&nboxes, 1, dst, seqno);
+            if (nboxes > 0) {
+                ParallelDescriptor::Send(bl.data().data(), nboxes, dst, seqno);
+            }
+            bl.clear();
+            break;
+        }
+        else if (rank + step < nprocs)
+        {
+            const int src = (rank + step + ioproc) % nprocs;
+            int nboxes = 0;
+            ParallelDescriptor::Recv(&nboxes, 1, src, seqno);
+            if (nboxes > 0) {
+                Vector<Box> boxes(nboxes);
+                ParallelDescriptor::Recv(boxes.data(), nboxes, src, seqno);
+                if (bl.isEmpty()) {
+                    bl.data() = std::move(boxes);
+                } else {
+                    // Only keep the parts of the received boxes that are
+                    // not covered yet.
+                    const BoxArray ba(bl);
+                    BoxList bl_new, bl_tmp;
+                    for (auto const& b : boxes) {
+                        ba.complementIn(bl_tmp, b);
+                        bl_new.join(bl_tmp);
+                    }
+                    bl.join(bl_new);
+                    bl.simplify();
+                }
+            }
+        }
+    }
+#endif
+
+    return bl;
+}
+
 }
@@ -589,19 +589,25 @@ TagBoxArray::local_collate_gpu (Gpu::PinnedVector<IntVect>& v) const
 #endif
 
 void
-TagBoxArray::collate (Gpu::PinnedVector<IntVect>& TheGlobalCollateSpace) const
+TagBoxArray::local_collate (Gpu::PinnedVector<IntVect>& v) const
 {
-    BL_PROFILE("TagBoxArray::collate()");
-
-    Gpu::PinnedVector<IntVect> TheLocalCollateSpace;
 #ifdef AMREX_USE_GPU
     if (Gpu::inLaunchRegion()) {
-        local_collate_gpu(TheLocalCollateSpace);
+        local_collate_gpu(v);
     } else
 #endif
     {
-        local_collate_cpu(TheLocalCollateSpace);
+        local_collate_cpu(v);
     }
+}
+
+void
+TagBoxArray::collate (Gpu::PinnedVector<IntVect>& TheGlobalCollateSpace) const
+{
+    BL_PROFILE("TagBoxArray::collate()");
+
+    Gpu::PinnedVector<IntVect> TheLocalCollateSpace;
+    local_collate(TheLocalCollateSpace);
 
     Long count = static_cast<Long>(TheLocalCollateSpace.size());
 
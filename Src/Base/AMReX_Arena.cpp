@@ -3,6 +3,7 @@
 #include <AMReX_BArena.H>
 #include <AMReX_CArena.H>
 #include <AMReX_PArena.H>
+#include <AMReX_TArena.H>
 
 #include <AMReX.H>
 #include <AMReX_BLProfiler.H>
@@ -48,6 +49,8 @@ namespace {
     Long the_comms_arena_release_threshold = std::numeric_limits<Long>::max();
     Long the_async_arena_release_threshold = std::numeric_limits<Long>::max();
     bool the_arena_is_managed = false;
+    bool the_arena_use_thread_cache = false;
+    Long the_arena_thread_cache_size = TArena::DefaultCacheSize;
     bool abort_on_out_of_gpu_memory = false;
 }
 
@@ -315,8 +318,17 @@ Arena::Initialize ()
     pp.queryAdd("the_comms_arena_release_threshold", the_comms_arena_release_threshold);
     pp.queryAdd(  "the_async_arena_release_threshold",   the_async_arena_release_threshold);
     pp.queryAdd("the_arena_is_managed", the_arena_is_managed);
+    pp.queryAdd("the_arena_use_thread_cache", the_arena_use_thread_cache);
+    pp.queryAdd("the_arena_thread_cache_size", the_arena_thread_cache_size);
     pp.queryAdd("abort_on_out_of_gpu_memory", abort_on_out_of_gpu_memory);
 
+#ifndef AMREX_USE_GPU
+    if (the_arena_use_thread_cache) {
+        the_arena = new TArena(static_cast<std::size_t>(the_arena_thread_cache_size),
+                               ArenaInfo{}.SetReleaseThreshold(the_arena_release_threshold));
+        the_arena->registerForProfiling("Cpu Memory");
+    } else
+#endif
     {
 #if defined(BL_COALESCE_FABS) || defined(AMREX_USE_GPU)
         ArenaInfo ai{};
@@ -459,9 +471,10 @@ Arena::PrintUsage ()
     }
 #endif
     if (The_Arena()) {
-        auto* p = dynamic_cast<CArena*>(The_Arena());
-        if (p) {
+        if (auto* p = dynamic_cast<CArena*>(The_Arena())) {
             p->PrintUsage("The         Arena");
+        } else if (auto* tp = dynamic_cast<TArena*>(The_Arena())) {
+            tp->PrintUsage("The         Arena");
         }
     }
     if (The_Device_Arena() && The_Device_Arena() != The_Arena()) {
@@ -511,9 +524,10 @@ Arena::PrintUsageToFiles (const std::string& filename, const std::string& messag
 #endif
 
     if (The_Arena()) {
-        auto* p = dynamic_cast<CArena*>(The_Arena());
-        if (p) {
+        if (auto* p = dynamic_cast<CArena*>(The_Arena())) {
             p->PrintUsage(ofs, "The         Arena", "    ");
+        } else if (auto* tp = dynamic_cast<TArena*>(The_Arena())) {
+            tp->PrintUsage(ofs, "The         Arena", "    ");
         }
     }
     if (The_Device_Arena() && The_Device_Arena() != The_Arena()) {
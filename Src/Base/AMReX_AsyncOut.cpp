@@ -1,10 +1,28 @@
 #include <AMReX_AsyncOut.H>
+#include <AMReX_Arena.H>
 #include <AMReX_BackgroundThread.H>
+#include <AMReX_BLProfiler.H>
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_Vector.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_Utility.H>
 #include <AMReX.H>
+#include <AMReX_Print.H>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <mutex>
+
+#ifdef _WIN32
+#include <filesystem>
+#include <system_error>
+#else
+#include <unistd.h>
+#endif
 
 namespace amrex::AsyncOut {
 
@@ -18,6 +36,33 @@ std::unique_ptr<BackgroundThread> s_thread;
 
 WriteInfo s_info;
 
+// Staging buffers and writer threads
+Long s_max_staging_size = Long(256)*1024*1024;
+Long s_chunk_size = Long(16)*1024*1024;
+int s_nwriters = 2;
+int s_verbose = 0;
+int s_max_buffers = 0;
+int s_next_writer = 0;
+Vector<std::unique_ptr<BackgroundThread> > s_writers;
+// The file each writer has open. Only touched by the writer's own thread.
+struct WriterFile {
+    std::string name;
+    std::ofstream ofs;
+};
+Vector<std::unique_ptr<WriterFile> > s_writer_files;
+// The number of writes submitted but not finished for each file
+std::map<std::string,int> s_pending_writes;
+std::mutex s_pending_mutex;
+std::condition_variable s_pending_cond;
+Vector<char*> s_all_buffers;
+Vector<char*> s_free_buffers;
+std::mutex s_buffer_mutex;
+std::condition_variable s_buffer_cond;
+
+// The writer threads are not OpenMP threads and cannot use TinyProfiler.
+std::atomic<Long> s_bytes_written{0};
+std::atomic<Long> s_write_nanoseconds{0};
+
 }
 
 void Initialize ()
@@ -27,6 +72,13 @@ void Initialize ()
     ParmParse pp("amrex");
     pp.queryAdd("async_out", s_asyncout);
     pp.queryAdd("async_out_nfiles", s_noutfiles);
+    pp.queryAdd("async_out_max_staging_size", s_max_staging_size);
+    pp.queryAdd("async_out_chunk_size", s_chunk_size);
+    pp.queryAdd("async_out_nwriters", s_nwriters);
+    pp.queryAdd("async_out_verbose", s_verbose);
+
+    AMREX_ALWAYS_ASSERT(s_chunk_size > 0 && s_nwriters > 0);
+    s_max_buffers = static_cast<int>(std::max(Long(1), s_max_staging_size/s_chunk_size));
 
     int nprocs = ParallelDescriptor::NProcs();
     s_noutfiles = std::min(s_noutfiles, nprocs);
@@ -50,6 +102,10 @@ void Initialize ()
 
     if (s_asyncout) {
         s_thread = std::make_unique<BackgroundThread>();
+        for (int i = 0; i < s_nwriters; ++i) {
+            s_writers.emplace_back(std::make_unique<BackgroundThread>());
+            s_writer_files.emplace_back(std::make_unique<WriterFile>());
+        }
     }
 
     ExecOnFinalize(Finalize);
@@ -61,6 +117,23 @@ void Finalize ()
         s_thread.reset();
     }
 
+    s_writers.clear();
+    s_writer_files.clear();
+    s_pending_writes.clear();
+
+    for (auto* p : s_all_buffers) {
+        The_Pinned_Arena()->free(p);
+    }
+    s_all_buffers.clear();
+    s_free_buffers.clear();
+
+    if (s_verbose && s_bytes_written > 0) {
+        amrex::Print() << "AsyncOut: wrote " << s_bytes_written.load() << " bytes in "
+                       << double(s_write_nanoseconds.load())*1.e-9 << " seconds\n";
+    }
+    s_bytes_written = 0;
+    s_write_nanoseconds = 0;
+
 #ifdef AMREX_USE_MPI
     if (s_comm != MPI_COMM_NULL) { MPI_Comm_free(&s_comm); }
     s_comm = MPI_COMM_NULL;
@@ -107,6 +180,9 @@ void Finish ()
     if (s_thread) {
         s_thread->Finish();
     }
+    for (auto& w : s_writers) {
+        w->Finish();
+    }
 }
 
 void Wait ()
@@ -139,4 +215,119 @@ void Notify ()
 #endif
 }
 
+std::size_t StagingBufferSize ()
+{
+    return static_cast<std::size_t>(s_chunk_size);
+}
+
+char* GetStagingBuffer ()
+{
+    std::unique_lock<std::mutex> lck(s_buffer_mutex);
+    if (s_free_buffers.empty()) {
+        if (static_cast<int>(s_all_buffers.size()) < s_max_buffers) {
+            auto* p = static_cast<char*>(The_Pinned_Arena()->alloc(s_chunk_size));
+            s_all_buffers.push_back(p);
+            return p;
+        } else {
+            // All buffers are in flight. Wait for the writers to catch up.
+            BL_PROFILE("AsyncOut::BackPressure");
+            s_buffer_cond.wait(lck, [] () { return !s_free_buffers.empty(); });
+        }
+    }
+    char* p = s_free_buffers.back();
+    s_free_buffers.pop_back();
+    return p;
+}
+
+void ReleaseStagingBuffer (char* p)
+{
+    {
+        std::lock_guard<std::mutex> lck(s_buffer_mutex);
+        s_free_buffers.push_back(p);
+    }
+    s_buffer_cond.notify_one();
+}
+
+void SubmitWrite (std::string const& file_name, Long offset, char const* data,
+                  std::size_t nbytes, std::function<void()>&& on_done)
+{
+    AMREX_ASSERT(!s_writers.empty());
+    const int iw = s_next_writer;
+    s_next_writer = (s_next_writer+1) % static_cast<int>(s_writers.size());
+    {
+        std::lock_guard<std::mutex> lck(s_pending_mutex);
+        ++s_pending_writes[file_name];
+    }
+    s_writers[iw]->Submit([=, on_done=std::move(on_done)] ()
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        WriterFile& wf = *s_writer_files[iw];
+        if (wf.name != file_name) {
+            // The file is kept open for the following chunks.
+            if (wf.ofs.is_open()) { wf.ofs.close(); }
+            wf.ofs.open(file_name, std::ios::binary | std::ios::in | std::ios::out);
+            if (!wf.ofs.is_open()) {
+                // Another process sharing the file may not have created it yet.
+                std::FILE* fp = std::fopen(file_name.c_str(), "ab");
+                if (fp) { std::fclose(fp); }
+                wf.ofs.clear();
+                wf.ofs.open(file_name, std::ios::binary | std::ios::in | std::ios::out);
+            }
+            if (!wf.ofs.good()) { amrex::FileOpenFailed(file_name); }
+            wf.name = file_name;
+        }
+        wf.ofs.seekp(offset, std::ios::beg);
+        wf.ofs.write(data, static_cast<std::streamsize>(nbytes));
+        if (!wf.ofs.good()) { amrex::Error("AsyncOut: failed to write " + file_name); }
+        auto t1 = std::chrono::steady_clock::now();
+        s_bytes_written += static_cast<Long>(nbytes);
+        s_write_nanoseconds += static_cast<Long>
+            (std::chrono::duration_cast<std::chrono::nanoseconds>(t1-t0).count());
+        if (on_done) { on_done(); }
+        {
+            std::lock_guard<std::mutex> lck(s_pending_mutex);
+            auto it = s_pending_writes.find(file_name);
+            if (--(it->second) == 0) { s_pending_writes.erase(it); }
+        }
+        s_pending_cond.notify_all();
+    });
+}
+
+void CloseFile (std::string const& file_name)
+{
+    for (int iw = 0, nw = static_cast<int>(s_writers.size()); iw < nw; ++iw) {
+        s_writers[iw]->Submit([=] ()
+        {
+            WriterFile& wf = *s_writer_files[iw];
+            if (wf.name == file_name) {
+                wf.ofs.close();
+                wf.name.clear();
+            }
+        });
+    }
+}
+
+void WaitForWrites (std::string const& file_name)
+{
+    std::unique_lock<std::mutex> lck(s_pending_mutex);
+    s_pending_cond.wait(lck, [&] () { return s_pending_writes.count(file_name) == 0; });
+}
+
+void ResizeFile (std::string const& file_name, Long nbytes)
+{
+    // Mode "ab" creates the file without truncating it.
+    std::FILE* fp = std::fopen(file_name.c_str(), "ab");
+    if (fp == nullptr) { amrex::FileOpenFailed(file_name); }
+    std::fclose(fp);
+#ifdef _WIN32
+    std::error_code ec;
+    std::filesystem::resize_file(std::filesystem::path{file_name},
+                                 static_cast<std::uintmax_t>(nbytes), ec);
+    bool failed = static_cast<bool>(ec);
+#else
+    bool failed = ::truncate(file_name.c_str(), static_cast<off_t>(nbytes)) != 0;
+#endif
+    if (failed) { amrex::Error("AsyncOut: failed to resize " + file_name); }
+}
+
 }
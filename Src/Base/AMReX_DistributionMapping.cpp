@@ -9,6 +9,7 @@
 #include <AMReX_VisMF.H>
 #include <AMReX_Utility.H>
 #include <AMReX_Morton.H>
+#include <AMReX_Machine.H>
 
 #include <iostream>
 #include <fstream>
@@ -74,6 +75,9 @@ DistributionMapping::strategy (DistributionMapping::Strategy how)
     case RRSFC:
         m_BuildMap = &DistributionMapping::RRSFCProcessorMap;
         break;
+    case HILBERT:
+        m_BuildMap = &DistributionMapping::HilbertProcessorMap;
+        break;
     default:
         amrex::Error("Bad DistributionMapping::Strategy");
     }
@@ -146,6 +150,10 @@ DistributionMapping::Initialize ()
         {
             strategy(RRSFC);
         }
+        else if (theStrategy == "HILBERT")
+        {
+            strategy(HILBERT);
+        }
         else
         {
             std::string msg("Unknown strategy: ");
@@ -1581,6 +1589,428 @@ DistributionMapping::RRSFCProcessorMap (const BoxArray&          boxes,
     RRSFCDoIt(boxes,nprocs);
 }
 
+namespace {
+
+    // Position of iv on a Hilbert curve through a lattice of 2^nbits points
+    // in each direction (J. Skilling, AIP Conf. Proc. 707, 381 (2004)).
+    // The components of iv must be in [0,2^nbits).
+    uint64_t makeHilbertKey (IntVect const& iv, int nbits)
+    {
+        Array<uint32_t,AMREX_SPACEDIM> X;
+        for (int i = 0; i < AMREX_SPACEDIM; ++i) {
+            X[i] = static_cast<uint32_t>(iv[i]);
+        }
+
+        const uint32_t M = 1U << (nbits-1);
+
+        // Inverse undo
+        for (uint32_t Q = M; Q > 1; Q >>= 1) {
+            const uint32_t P = Q - 1;
+            for (int i = 0; i < AMREX_SPACEDIM; ++i) {
+                if (X[i] & Q) {
+                    X[0] ^= P;
+                } else {
+                    const uint32_t t = (X[0] ^ X[i]) & P;
+                    X[0] ^= t;
+                    X[i] ^= t;
+                }
+            }
+        }
+
+        // Gray encode
+        for (int i = 1; i < AMREX_SPACEDIM; ++i) {
+            X[i] ^= X[i-1];
+        }
+        uint32_t t = 0;
+        for (uint32_t Q = M; Q > 1; Q >>= 1) {
+            if (X[AMREX_SPACEDIM-1] & Q) { t ^= Q - 1; }
+        }
+        for (int i = 0; i < AMREX_SPACEDIM; ++i) {
+            X[i] ^= t;
+        }
+
+        // Interleave the transposed bits, most significant first
+        uint64_t key = 0;
+        for (int b = nbits-1; b >= 0; --b) {
+            for (int i = 0; i < AMREX_SPACEDIM; ++i) {
+                key = (key << 1) | ((X[i] >> b) & 1U);
+            }
+        }
+        return key;
+    }
+
+    // Split boxes, which are in curve order, into contiguous segments. The
+    // weight of segment i is close to cap[i]/sum(cap) of the total weight.
+    void
+    SplitCurve (const std::vector<int>& boxes, const std::vector<Long>& wgts,
+                const std::vector<int>& cap, std::vector<std::vector<int> >& v)
+    {
+        const int nparts = static_cast<int>(cap.size());
+        v.clear();
+        v.resize(nparts);
+
+        Real totalvol = 0;
+        for (int b : boxes) { totalvol += static_cast<Real>(wgts[b]); }
+        const Real totalcap = static_cast<Real>(std::accumulate(cap.begin(), cap.end(), 0));
+
+        int  ipart  = 0;
+        Real endcap = static_cast<Real>(cap[0]);
+        Real vol    = 0;
+        for (int b : boxes)
+        {
+            const auto w = static_cast<Real>(wgts[b]);
+            // Move on once the midpoint of the box is past the end of the segment.
+            while (ipart < nparts-1 && (vol + Real(0.5)*w)*totalcap > endcap*totalvol) {
+                ++ipart;
+                endcap += static_cast<Real>(cap[ipart]);
+            }
+            v[ipart].push_back(b);
+            vol += w;
+        }
+    }
+
+    // Split boxes, which are in curve order, into contiguous segments for
+    // the nodes like SplitCurve. Among the cut positions whose weight is
+    // within tol of the total weight per part of the ideal cut, we pick the
+    // one with the fewest ghost cells between the boxes before and after
+    // it, so that the boundaries between nodes are short.
+    void
+    SplitCurveMinCut (const BoxArray& ba, const std::vector<int>& boxes,
+                      const std::vector<Long>& wgts, const std::vector<int>& cap,
+                      Real tol, std::vector<std::vector<int> >& v)
+    {
+        const int nparts = static_cast<int>(cap.size());
+        const int N = static_cast<int>(boxes.size());
+        v.clear();
+        v.resize(nparts);
+
+        std::vector<int> pos(ba.size(), -1);
+        for (int p = 0; p < N; ++p) { pos[boxes[p]] = p; }
+
+        // psum[p] is the weight of the first p boxes, and cut[p] is the
+        // number of ghost cells between them and the others.
+        std::vector<Real> psum(N+1, Real(0));
+        std::vector<Long> cut(N+1, 0);
+        for (int p = 0; p < N; ++p) {
+            const int b = boxes[p];
+            psum[p+1] = psum[p] + static_cast<Real>(wgts[b]);
+            Long dcut = 0;
+            for (auto const& is : ba.intersections(amrex::grow(ba[b],1))) {
+                const int q = pos[is.first];
+                if (q < 0 || q == p) { continue; }
+                dcut += (q > p) ? is.second.numPts() : -is.second.numPts();
+            }
+            cut[p+1] = cut[p] + dcut;
+        }
+        const Real totalvol = psum[N];
+        const Real totalcap = static_cast<Real>(std::accumulate(cap.begin(), cap.end(), 0));
+        const Real window = tol * totalvol / static_cast<Real>(nparts);
+
+        int begin = 0;
+        Real endcap = 0;
+        for (int ipart = 0; ipart < nparts-1; ++ipart)
+        {
+            endcap += static_cast<Real>(cap[ipart]);
+            const Real target = totalvol * endcap / totalcap;
+
+            // The cut of SplitCurve: the last box is the one whose midpoint
+            // is not past the target.
+            int best = begin;
+            while (best < N && (psum[best] + psum[best+1])*Real(0.5) <= target) { ++best; }
+            Real best_dist = std::abs(psum[best] - target);
+
+            for (int p = begin; p <= N; ++p) {
+                if (psum[p] < target - window) { continue; }
+                if (psum[p] > target + window) { break; }
+                const Real dist = std::abs(psum[p] - target);
+                if (cut[p] < cut[best] || (cut[p] == cut[best] && dist < best_dist)) {
+                    best = p;
+                    best_dist = dist;
+                }
+            }
+
+            for (int p = begin; p < best; ++p) {
+                v[ipart].push_back(boxes[p]);
+            }
+            begin = std::max(begin, best);
+        }
+        for (int p = begin; p < N; ++p) {
+            v[nparts-1].push_back(boxes[p]);
+        }
+    }
+
+    // The number of ghost cells of the boxes that come from other parts
+    Long
+    CountCut (const BoxArray& ba, const std::vector<std::vector<int> >& v)
+    {
+        std::vector<int> part(ba.size(), -1);
+        for (int i = 0, n = static_cast<int>(v.size()); i < n; ++i) {
+            for (int b : v[i]) { part[b] = i; }
+        }
+        Long r = 0;
+        for (int i = 0, n = static_cast<int>(v.size()); i < n; ++i) {
+            for (int b : v[i]) {
+                for (auto const& is : ba.intersections(amrex::grow(ba[b],1))) {
+                    if (part[is.first] >= 0 && part[is.first] != i) {
+                        r += is.second.numPts();
+                    }
+                }
+            }
+        }
+        return r;
+    }
+}
+
+void
+DistributionMapping::HilbertDoIt (const BoxArray&          boxes,
+                                  const std::vector<Long>& wgts,
+                                  Real*                    eff)
+{
+    if (flag_verbose_mapper) {
+        Print() << "DM: HilbertDoIt called..." << '\n';
+    }
+
+    BL_PROFILE("DistributionMapping::HilbertDoIt()");
+
+    const int N = static_cast<int>(boxes.size());
+    if (N == 0) {
+        if (eff) { *eff = Real(1.0); }
+        return;
+    }
+
+    const int nprocs = ParallelContext::NProcsSub();
+
+    //
+    // Group the ranks by node.  DistributionMapping.node_size overrides the
+    // node layout found by Machine.
+    //
+    Vector<int> const& node_of_rank = Machine::nodeOfRank();
+    std::vector<std::vector<int> > node_ranks;
+    {
+        std::map<int,int> node_index;
+        for (int r = 0; r < nprocs; ++r) {
+            const int g = ParallelContext::local_to_global_rank(r);
+            int node = 0;
+            if (node_size > 0) {
+                node = g / node_size;
+            } else if (g < static_cast<int>(node_of_rank.size())) {
+                node = node_of_rank[g];
+            }
+            auto it = node_index.emplace(node, static_cast<int>(node_ranks.size())).first;
+            if (it->second == static_cast<int>(node_ranks.size())) {
+                node_ranks.emplace_back();
+            }
+            node_ranks[it->second].push_back(r);
+        }
+    }
+    const int nnodes = static_cast<int>(node_ranks.size());
+
+    if (flag_verbose_mapper) {
+        Print() << "  (nprocs, nnodes) = (" << nprocs << ", " << nnodes << ")\n";
+    }
+
+    //
+    // Put'm in Hilbert space filling curve order.  The common trailing
+    // zero bits of the corners are dropped so that the curve runs through
+    // the lattice of boxes for grids made of boxes of equal size.
+    //
+    std::vector<IntVect> corners;
+    corners.reserve(N);
+    for (int i = 0; i < N; ++i) {
+        const Box& bx = boxes[i];
+        corners.push_back(bx.smallEnd());
+    }
+    const Box mbx = boxes.minimalBox();
+    const IntVect& lo = mbx.smallEnd();
+    uint32_t bits_or = 0;
+    for (auto& iv : corners) {
+        iv -= lo;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bits_or |= static_cast<uint32_t>(iv[idim]);
+        }
+    }
+    int shift = 0;
+    while (bits_or != 0 && (bits_or & 1U) == 0) {
+        bits_or >>= 1;
+        ++shift;
+    }
+    int nbits = 1;
+    while (nbits < 32 && (bits_or >> nbits) != 0) { ++nbits; }
+    constexpr int max_bits = std::min(64/AMREX_SPACEDIM, 31);
+    if (nbits > max_bits) {
+        shift += nbits - max_bits;
+        nbits = max_bits;
+    }
+
+    std::vector<std::pair<uint64_t,int> > keys;
+    keys.reserve(N);
+    for (int i = 0; i < N; ++i) {
+        IntVect& iv = corners[i];
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            iv[idim] = static_cast<int>(static_cast<uint32_t>(iv[idim]) >> shift);
+        }
+        keys.emplace_back(makeHilbertKey(iv, nbits), i);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<int> curve;
+    curve.reserve(N);
+    for (auto const& k : keys) {
+        curve.push_back(k.second);
+    }
+    keys.clear();
+
+    //
+    // Give contiguous segments of the curve to the nodes, and then split the
+    // segment of each node among its ranks.
+    //
+    std::vector<int> node_cap;
+    node_cap.reserve(nnodes);
+    for (auto const& nr : node_ranks) {
+        node_cap.push_back(static_cast<int>(nr.size()));
+    }
+
+    std::vector<std::vector<int> > node_boxes;
+    if (nnodes > 1)
+    {
+        //
+        // The faces between the segments of the Hilbert curve are not always
+        // the shortest.  We also try the Morton curve, and keep the split
+        // with the fewer ghost cells between the nodes.  In both cases a cut
+        // may move by up to hilbert_node_tol of the weight per node if that
+        // makes the boundary shorter.
+        //
+        constexpr Real hilbert_node_tol = Real(0.02);
+        SplitCurveMinCut(boxes, curve, wgts, node_cap, hilbert_node_tol, node_boxes);
+
+        std::vector<SFCToken> tokens;
+        tokens.reserve(N);
+        for (int i = 0; i < N; ++i) {
+            const Box& bx = boxes[i];
+            tokens.push_back(makeSFCToken(i, bx.smallEnd()));
+        }
+        std::sort(tokens.begin(), tokens.end(), SFCToken::Compare());
+        std::vector<int> zcurve;
+        zcurve.reserve(N);
+        for (auto const& t : tokens) {
+            zcurve.push_back(t.m_box);
+        }
+        tokens.clear();
+
+        std::vector<std::vector<int> > znode_boxes;
+        SplitCurveMinCut(boxes, zcurve, wgts, node_cap, hilbert_node_tol, znode_boxes);
+        const Long hcut = CountCut(boxes, node_boxes);
+        const Long zcut = CountCut(boxes, znode_boxes);
+
+        if (flag_verbose_mapper) {
+            Print() << "  Inter-node ghost cells: Hilbert " << hcut << ", Morton " << zcut << '\n';
+        }
+
+        if (zcut < hcut) {
+            // The ranks of a node still split its boxes in Hilbert order.
+            std::vector<int> hpos(N);
+            for (int p = 0; p < N; ++p) { hpos[curve[p]] = p; }
+            for (auto& nb : znode_boxes) {
+                std::sort(nb.begin(), nb.end(),
+                          [&] (int i, int j) { return hpos[i] < hpos[j]; });
+            }
+            std::swap(node_boxes, znode_boxes);
+        }
+    }
+    else
+    {
+        node_boxes.push_back(std::move(curve));
+    }
+
+    std::vector<Long> rank_wgt(nprocs, 0);
+    std::vector<std::vector<int> > rank_boxes;
+    for (int inode = 0; inode < nnodes; ++inode)
+    {
+        const std::vector<int>& ranks = node_ranks[inode];
+        SplitCurve(node_boxes[inode], wgts, std::vector<int>(ranks.size(),1), rank_boxes);
+        for (int j = 0, nr = static_cast<int>(ranks.size()); j < nr; ++j) {
+            const int grank = ParallelContext::local_to_global_rank(ranks[j]);
+            for (int b : rank_boxes[j]) {
+                m_ref->m_pmap[b] = grank;
+                rank_wgt[ranks[j]] += wgts[b];
+            }
+        }
+
+        if (flag_verbose_mapper) {
+            Long w = 0;
+            for (int b : node_boxes[inode]) { w += wgts[b]; }
+            Print() << "  Node " << inode << " contains " << node_boxes[inode].size()
+                    << " boxes of weight " << w << '\n';
+        }
+    }
+
+    if (eff || verbose)
+    {
+        Long sum_wgt = 0, max_wgt = 0;
+        for (Long W : rank_wgt) {
+            max_wgt = std::max(max_wgt, W);
+            sum_wgt += W;
+        }
+        Real efficiency = (max_wgt > 0)
+            ? static_cast<Real>(sum_wgt)/static_cast<Real>(nprocs*max_wgt) : Real(1.0);
+        if (eff) { *eff = efficiency; }
+
+        if (verbose)
+        {
+            amrex::Print() << "Hilbert efficiency: " << efficiency << '\n';
+        }
+    }
+}
+
+void
+DistributionMapping::HilbertProcessorMap (const BoxArray& boxes, int nprocs)
+{
+    BL_ASSERT( ! boxes.empty());
+
+    m_ref->clear();
+    m_ref->m_pmap.resize(boxes.size());
+
+    if (boxes.size() < Long(sfc_threshold)*nprocs)
+    {
+        KnapSackProcessorMap(boxes,nprocs);
+    }
+    else
+    {
+        std::vector<Long> wgts;
+
+        wgts.reserve(boxes.size());
+
+        for (int i = 0, N = static_cast<int>(boxes.size()); i < N; ++i)
+        {
+            wgts.push_back(boxes[i].numPts());
+        }
+
+        HilbertDoIt(boxes,wgts);
+    }
+}
+
+void
+DistributionMapping::HilbertProcessorMap (const BoxArray&          boxes,
+                                          const std::vector<Long>& wgts,
+                                          int                      nprocs,
+                                          Real*                    eff)
+{
+    BL_ASSERT( ! boxes.empty());
+    BL_ASSERT(boxes.size() == static_cast<int>(wgts.size()));
+
+    m_ref->clear();
+    m_ref->m_pmap.resize(wgts.size());
+
+    if (boxes.size() < Long(sfc_threshold)*nprocs)
+    {
+        KnapSackProcessorMap(wgts,nprocs,eff);
+    }
+    else
+    {
+        HilbertDoIt(boxes,wgts,eff);
+    }
+}
+
 DistributionMapping
 DistributionMapping::makeKnapSack (const Vector<Real>& rcost, int nmax)
 {
@@ -1828,6 +2258,29 @@ DistributionMapping::makeSFC (const Vector<Real>& rcost, const BoxArray& ba, Rea
     return r;
 }
 
+DistributionMapping
+DistributionMapping::makeHilbert (const Vector<Real>& rcost, const BoxArray& ba, Real& eff)
+{
+    BL_PROFILE("makeHilbert");
+
+    DistributionMapping r;
+
+    Vector<Long> cost(rcost.size());
+
+    Real wmax = *std::max_element(rcost.begin(), rcost.end());
+    Real scale = (wmax == 0) ? 1.e9_rt : 1.e9_rt/wmax;
+
+    for (int i = 0; i < rcost.size(); ++i) {
+        cost[i] = Long(rcost[i]*scale) + 1L;
+    }
+
+    int nprocs = ParallelContext::NProcsSub();
+
+    r.HilbertProcessorMap(ba, cost, nprocs, &eff);
+
+    return r;
+}
+
 DistributionMapping
 DistributionMapping::makeSFC (const LayoutData<Real>& rcost_local,
                               Real& currentEfficiency, Real& proposedEfficiency,
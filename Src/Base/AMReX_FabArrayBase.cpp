@@ -28,6 +28,7 @@
 namespace amrex {
 
 int FabArrayBase::MaxComp = 25;
+bool FabArrayBase::use_neighbor_collectives = false;
 
 #if defined(AMREX_USE_GPU)
 
@@ -63,6 +64,7 @@ FabArrayBase::CPCache              FabArrayBase::m_TheCPCache;
 FabArrayBase::RB90Cache            FabArrayBase::m_TheRB90Cache;
 FabArrayBase::RB180Cache           FabArrayBase::m_TheRB180Cache;
 FabArrayBase::PolarBCache          FabArrayBase::m_ThePolarBCache;
+FabArrayBase::ShellBoxesCache      FabArrayBase::m_TheShellBoxesCache;
 FabArrayBase::FPinfoCache          FabArrayBase::m_TheFillPatchCache;
 FabArrayBase::CFinfoCache          FabArrayBase::m_TheCrseFineCache;
 
@@ -128,6 +130,8 @@ FabArrayBase::Initialize ()
         MaxComp = 1;
     }
 
+    pp.queryAdd("use_neighbor_collectives", FabArrayBase::use_neighbor_collectives);
+
     ParmParse ppmf("amrex.mf");
     ppmf.queryAdd("alloc_single_chunk", FabArrayBase::m_alloc_single_chunk);
 
@@ -1790,6 +1794,82 @@ FabArrayBase::getPolarB (const IntVect& nghost, const Box& domain) const
     return *new_polarb;
 }
 
+FabArrayBase::ShellBoxes::ShellBoxes (const FabArrayBase& fa, const IntVect& nghost)
+    : m_bat(fa.boxArray().transformer()), m_ngrow(nghost)
+{
+    BL_PROFILE("FabArrayBase::ShellBoxes::ShellBoxes()");
+
+    const int N = fa.local_size();
+    m_interior.reserve(N);
+    m_shell.reserve(N*2*AMREX_SPACEDIM);
+
+    for (int lidx = 0; lidx < N; ++lidx)
+    {
+        const Box& vbx = fa.box(fa.IndexArray()[lidx]);
+        const Box& ibx = amrex::grow(vbx, -nghost);
+        if (ibx.ok()) {
+            m_interior.push_back(BoxTag{ibx, lidx});
+            for (const Box& b : amrex::boxDiff(vbx, ibx)) {
+                m_shell.push_back(BoxTag{b, lidx});
+            }
+        } else {
+            m_shell.push_back(BoxTag{vbx, lidx});
+        }
+    }
+
+#ifdef AMREX_USE_GPU
+    detail::build_shell_tags(m_hp, m_dp, m_d_interior, m_d_shell, m_interior, m_shell);
+#endif
+}
+
+FabArrayBase::ShellBoxes::~ShellBoxes ()
+{
+#ifdef AMREX_USE_GPU
+    detail::destroy_par_for_nblocks(m_hp, m_dp);
+#endif
+}
+
+const FabArrayBase::ShellBoxes&
+FabArrayBase::getShellBoxes (const IntVect& nghost) const
+{
+    AMREX_ASSERT(getBDKey() == m_bdkey);
+    auto er_it = m_TheShellBoxesCache.equal_range(m_bdkey);
+    for (auto it = er_it.first; it != er_it.second; ++it)
+    {
+        if (it->second->m_bat   == boxArray().transformer() &&
+            it->second->m_ngrow == nghost)
+        {
+            return *(it->second);
+        }
+    }
+
+    auto *new_sb = new ShellBoxes(*this, nghost);
+    m_TheShellBoxesCache.insert(er_it.second, ShellBoxesCache::value_type(m_bdkey,new_sb));
+
+    return *new_sb;
+}
+
+void
+FabArrayBase::flushShellBoxes (bool no_assertion) const
+{
+    amrex::ignore_unused(no_assertion);
+    AMREX_ASSERT(no_assertion || getBDKey() == m_bdkey);
+    auto er_it = m_TheShellBoxesCache.equal_range(m_bdkey);
+    for (auto it = er_it.first; it != er_it.second; ++it) {
+        delete it->second;
+    }
+    m_TheShellBoxesCache.erase(er_it.first, er_it.second);
+}
+
+void
+FabArrayBase::flushShellBoxesCache ()
+{
+    for (auto const& it : m_TheShellBoxesCache) {
+        delete it.second;
+    }
+    m_TheShellBoxesCache.clear();
+}
+
 FabArrayBase::FPinfo::FPinfo (const FabArrayBase& srcfa,
                               const FabArrayBase& dstfa,
                               const Box&          dstdomain,
@@ -2205,6 +2285,142 @@ FabArrayBase::flushCFinfo (bool no_assertion) const
     m_TheCrseFineCache.erase(er_it.first, er_it.second);
 }
 
+#ifdef BL_USE_MPI
+
+FabArrayBase::NeighborComm::~NeighborComm ()
+{
+    clear();
+}
+
+FabArrayBase::NeighborComm::NeighborComm (NeighborComm&& rhs) noexcept
+    : m_comm(std::exchange(rhs.m_comm, MPI_COMM_NULL)),
+      m_parent(std::exchange(rhs.m_parent, MPI_COMM_NULL))
+{}
+
+FabArrayBase::NeighborComm&
+FabArrayBase::NeighborComm::operator= (NeighborComm&& rhs) noexcept
+{
+    if (this != &rhs) {
+        clear();
+        m_comm = std::exchange(rhs.m_comm, MPI_COMM_NULL);
+        m_parent = std::exchange(rhs.m_parent, MPI_COMM_NULL);
+    }
+    return *this;
+}
+
+void
+FabArrayBase::NeighborComm::clear ()
+{
+    if (m_comm != MPI_COMM_NULL) {
+        int finalized = 0;
+        MPI_Finalized(&finalized);
+        if (!finalized) { MPI_Comm_free(&m_comm); }
+    }
+    m_comm = MPI_COMM_NULL;
+    m_parent = MPI_COMM_NULL;
+}
+
+MPI_Comm
+FabArrayBase::CommMetaData::neighborComm () const
+{
+    MPI_Comm comm = ParallelContext::CommunicatorSub();
+    if (m_nbr_comm.m_comm == MPI_COMM_NULL || m_nbr_comm.m_parent != comm)
+    {
+        BL_PROFILE("FabArrayBase::CommMetaData::neighborComm()");
+
+        m_nbr_comm.clear();
+
+        Vector<int> sources;
+        Vector<int> destinations;
+        sources.reserve(m_RcvTags->size());
+        destinations.reserve(m_SndTags->size());
+        for (auto const& kv : *m_RcvTags) {
+            sources.push_back(ParallelContext::global_to_local_rank(kv.first));
+        }
+        for (auto const& kv : *m_SndTags) {
+            destinations.push_back(ParallelContext::global_to_local_rank(kv.first));
+        }
+
+        BL_MPI_REQUIRE( MPI_Dist_graph_create_adjacent
+                            (comm,
+                             static_cast<int>(sources.size()), sources.data(), MPI_UNWEIGHTED,
+                             static_cast<int>(destinations.size()), destinations.data(), MPI_UNWEIGHTED,
+                             MPI_INFO_NULL, 0, &m_nbr_comm.m_comm) );
+        m_nbr_comm.m_parent = comm;
+    }
+    return m_nbr_comm.m_comm;
+}
+
+namespace {
+    // The same data types as used by ParallelDescriptor::Asend/Arecv for a message of nbytes.
+    void select_neighbor_data_type (std::size_t nbytes, int& count, MPI_Datatype& type)
+    {
+        const int t = ParallelDescriptor::select_comm_data_type(nbytes);
+        if (t == 1) {
+            type = ParallelDescriptor::Mpi_typemap<char>::type();
+            count = static_cast<int>(nbytes);
+        } else if (t == 2) {
+            type = ParallelDescriptor::Mpi_typemap<unsigned long long>::type();
+            count = static_cast<int>(nbytes/sizeof(unsigned long long));
+        } else if (t == 3) {
+            type = ParallelDescriptor::Mpi_typemap<ParallelDescriptor::lull_t>::type();
+            count = static_cast<int>(nbytes/sizeof(ParallelDescriptor::lull_t));
+        } else {
+            amrex::Abort("FabArrayBase::PostNeighborAlltoall: a message of " + std::to_string(nbytes)
+                         + " bytes exceeds the MPI limit of INT_MAX elements of "
+                         + std::to_string(sizeof(ParallelDescriptor::lull_t))
+                         + " bytes. Use more MPI processes or smaller boxes, or reduce fabarray.maxcomp.");
+        }
+    }
+}
+
+void
+FabArrayBase::PostNeighborAlltoall (const CommMetaData&        cmd,
+                                    char*                      the_send_data,
+                                    Vector<char*> const&       send_data,
+                                    Vector<std::size_t> const& send_size,
+                                    char*                      the_recv_data,
+                                    Vector<char*> const&       recv_data,
+                                    Vector<std::size_t> const& recv_size,
+                                    MPI_Request&               req)
+{
+    BL_PROFILE("FabArrayBase::PostNeighborAlltoall()");
+
+    MPI_Comm comm = cmd.neighborComm();
+
+    const auto N_snds = static_cast<int>(send_size.size());
+    const auto N_rcvs = static_cast<int>(recv_size.size());
+    AMREX_ASSERT(N_snds == 0 || N_snds == static_cast<int>(cmd.m_SndTags->size()));
+    AMREX_ASSERT(N_rcvs == 0 || N_rcvs == static_cast<int>(cmd.m_RcvTags->size()));
+
+    // Processes with nothing to send may not have set up the send buffers.
+    const auto outdegree = static_cast<int>(cmd.m_SndTags->size());
+    const auto indegree  = static_cast<int>(cmd.m_RcvTags->size());
+
+    Vector<int> scounts(outdegree, 0), rcounts(indegree, 0);
+    Vector<MPI_Aint> sdispls(outdegree, 0), rdispls(indegree, 0);
+    Vector<MPI_Datatype> stypes(outdegree, MPI_CHAR), rtypes(indegree, MPI_CHAR);
+
+    for (int i = 0; i < N_snds; ++i) {
+        if (send_size[i] > 0) {
+            select_neighbor_data_type(send_size[i], scounts[i], stypes[i]);
+            sdispls[i] = static_cast<MPI_Aint>(send_data[i] - the_send_data);
+        }
+    }
+    for (int i = 0; i < N_rcvs; ++i) {
+        if (recv_size[i] > 0) {
+            select_neighbor_data_type(recv_size[i], rcounts[i], rtypes[i]);
+            rdispls[i] = static_cast<MPI_Aint>(recv_data[i] - the_recv_data);
+        }
+    }
+
+    BL_MPI_REQUIRE( MPI_Ineighbor_alltoallw(the_send_data, scounts.data(), sdispls.data(), stypes.data(),
+                                            the_recv_data, rcounts.data(), rdispls.data(), rtypes.data(),
+                                            comm, &req) );
+}
+
+#endif
+
 void
 FabArrayBase::Finalize ()
 {
@@ -2213,6 +2429,7 @@ FabArrayBase::Finalize ()
     FabArrayBase::flushRB90Cache();
     FabArrayBase::flushRB180Cache();
     FabArrayBase::flushPolarBCache();
+    FabArrayBase::flushShellBoxesCache();
     FabArrayBase::flushTileArrayCache();
 
 #ifdef AMREX_USE_GPU
@@ -2447,6 +2664,7 @@ FabArrayBase::clearThisBD (bool no_assertion) const
             flushRB90(no_assertion);
             flushRB180(no_assertion);
             flushPolarB(no_assertion);
+            flushShellBoxes(no_assertion);
 #ifdef AMREX_USE_GPU
             flushParForInfo(no_assertion);
 #endif
@@ -2502,7 +2720,10 @@ CheckRcvStats (Vector<MPI_Status>& recv_stats, const Vector<std::size_t>& recv_s
                               &tmp_count);
                 count = sizeof(ParallelDescriptor::lull_t) * tmp_count;
             } else {
-                amrex::Abort("TODO: message size is too big");
+                amrex::Abort("CheckRcvStats: a message of " + std::to_string(recv_size[i])
+                             + " bytes exceeds the MPI limit of INT_MAX elements of "
+                             + std::to_string(sizeof(ParallelDescriptor::lull_t))
+                             + " bytes. Use more MPI processes or smaller boxes, or reduce fabarray.maxcomp.");
             }
 
             if (count != recv_size[i]) {
@@ -0,0 +1,363 @@
+#include <AMReX_FabCompression.H>
+#include <AMReX_BLassert.H>
+#include <AMReX_FPC.H>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <istream>
+#include <limits>
+#include <sstream>
+#include <string>
+
+namespace amrex::FabCompression {
+
+namespace {
+
+const std::string TheCompressedFabPrefix("CFAB");
+
+// How a component is encoded
+enum Quant : int { Quant_None = 0, Quant_Uniform = 1, Quant_Constant = 2 };
+enum Codec : int { Codec_Raw = 0, Codec_ShuffleLZ = 1 };
+
+struct CompInfo
+{
+    int quant = Quant_None;
+    int codec = Codec_Raw;
+    int elem = 0;      // bytes per element before compression
+    Long nbytes = 0;   // bytes of the payload
+    double offset = 0; // quantized value q represents offset + q*step
+    double step = 0;
+};
+
+constexpr int  lz_min_match = 4;
+constexpr int  lz_hash_bits = 16;
+constexpr Long lz_max_offset = 65535;
+
+std::uint32_t read32 (char const* p)
+{
+    std::uint32_t r;
+    std::memcpy(&r, p, sizeof(r));
+    return r;
+}
+
+std::uint32_t lzHash (std::uint32_t seq)
+{
+    return (seq * 2654435761U) >> (32 - lz_hash_bits);
+}
+
+void lzPutLength (Vector<char>& dst, Long len)
+{
+    while (len >= 255) {
+        dst.push_back(static_cast<char>(255));
+        len -= 255;
+    }
+    dst.push_back(static_cast<char>(len));
+}
+
+Long lzGetLength (char const* src, Long nsrc, Long& ip)
+{
+    Long len = 0;
+    unsigned char b;
+    do {
+        if (ip >= nsrc) { amrex::Abort("FabCompression: corrupted LZ data"); }
+        b = static_cast<unsigned char>(src[ip++]);
+        len += b;
+    } while (b == 255);
+    return len;
+}
+
+// Bytes of the same significance become adjacent.
+void shuffle (char const* src, Long n, int elem, char* dst)
+{
+    for (int b = 0; b < elem; ++b) {
+        char* AMREX_RESTRICT d = dst + b*n;
+        for (Long i = 0; i < n; ++i) {
+            d[i] = src[i*elem+b];
+        }
+    }
+}
+
+void unshuffle (char const* src, Long n, int elem, char* dst)
+{
+    for (int b = 0; b < elem; ++b) {
+        char const* AMREX_RESTRICT s = src + b*n;
+        for (Long i = 0; i < n; ++i) {
+            dst[i*elem+b] = s[i];
+        }
+    }
+}
+
+// Quantize with |v - (offset + q*step)| <= tol*(max(v)-min(v)). The
+// integers are delta coded and stored in little-endian byte order. Returns
+// false if the data are not suitable, e.g., because of NaNs.
+bool quantize (Real const* v, Long n, Real tol, CompInfo& ci, Vector<char>& raw)
+{
+    double vmin = std::numeric_limits<double>::max();
+    double vmax = std::numeric_limits<double>::lowest();
+    for (Long i = 0; i < n; ++i) {
+        auto x = static_cast<double>(v[i]);
+        if (!std::isfinite(x)) { return false; }
+        vmin = std::min(vmin, x);
+        vmax = std::max(vmax, x);
+    }
+
+    if (n == 0 || vmax == vmin) {
+        ci.quant = Quant_Constant;
+        ci.elem = 0;
+        ci.offset = (n == 0) ? 0.0 : vmin;
+        raw.clear();
+        return true;
+    }
+
+    const double eb = static_cast<double>(tol) * (vmax - vmin);
+    const double step = 2.0*eb;
+    const double qmax = (vmax - vmin) / step;
+    if (!(qmax < 4.e15)) { return false; }
+    const int elem = (qmax < 1.e9) ? 4 : 8;
+
+    raw.resize(n*elem);
+    std::int64_t qprev = 0;
+    for (Long i = 0; i < n; ++i) {
+        const auto q = static_cast<std::int64_t>(std::llround((static_cast<double>(v[i])-vmin)/step));
+        const auto r = static_cast<Real>(vmin + static_cast<double>(q)*step);
+        if (std::abs(static_cast<double>(r) - static_cast<double>(v[i])) > eb) { return false; }
+        const std::int64_t d = q - qprev;
+        qprev = q;
+        auto z = (static_cast<std::uint64_t>(d) << 1) ^ static_cast<std::uint64_t>(d >> 63); // NOLINT
+        for (int b = 0; b < elem; ++b) {
+            raw[i*elem+b] = static_cast<char>(z & 0xFF);
+            z >>= 8;
+        }
+    }
+
+    ci.quant = Quant_Uniform;
+    ci.elem = elem;
+    ci.offset = vmin;
+    ci.step = step;
+    return true;
+}
+
+void dequantize (Real* v, Long n, CompInfo const& ci, char const* raw)
+{
+    std::int64_t q = 0;
+    for (Long i = 0; i < n; ++i) {
+        std::uint64_t z = 0;
+        for (int b = ci.elem-1; b >= 0; --b) {
+            z = (z << 8) | static_cast<unsigned char>(raw[i*ci.elem+b]);
+        }
+        auto d = static_cast<std::int64_t>(z >> 1) ^ -static_cast<std::int64_t>(z & 1);
+        q += d;
+        v[i] = static_cast<Real>(ci.offset + static_cast<double>(q)*ci.step);
+    }
+}
+
+void encodeComponent (Real const* v, Long n, RealDescriptor const& rd, Real tol,
+                      CompInfo& ci, Vector<char>& payload)
+{
+    Vector<char> raw;
+    if (!(tol > Real(0)) || !quantize(v, n, tol, ci, raw)) {
+        ci = CompInfo{};
+        ci.elem = rd.numBytes();
+        raw.resize(n*ci.elem);
+        if (rd == FPC::NativeRealDescriptor()) {
+            std::memcpy(raw.data(), v, raw.size());
+        } else {
+            RealDescriptor::convertFromNativeFormat(raw.data(), n, v, rd);
+        }
+    }
+
+    payload.clear();
+    if (raw.empty()) {
+        ci.codec = Codec_Raw;
+    } else {
+        Vector<char> shuffled(raw.size());
+        shuffle(raw.data(), n, ci.elem, shuffled.data());
+        lzCompress(shuffled.data(), Long(shuffled.size()), payload);
+        if (payload.size() < raw.size()) {
+            ci.codec = Codec_ShuffleLZ;
+        } else {
+            ci.codec = Codec_Raw;
+            payload = std::move(raw);
+        }
+    }
+    ci.nbytes = Long(payload.size());
+}
+
+void decodeComponent (Real* v, Long n, RealDescriptor const& rd, CompInfo const& ci,
+                      std::istream& is)
+{
+    if (ci.quant == Quant_Constant) {
+        std::fill(v, v+n, static_cast<Real>(ci.offset));
+        return;
+    }
+
+    Vector<char> payload(ci.nbytes);
+    is.read(payload.data(), ci.nbytes);
+    if (!is.good()) { amrex::Error("FabCompression::decode: read failed"); }
+
+    Vector<char> raw;
+    if (ci.codec == Codec_ShuffleLZ) {
+        Vector<char> shuffled(n*ci.elem);
+        lzDecompress(payload.data(), ci.nbytes, shuffled.data(), Long(shuffled.size()));
+        raw.resize(shuffled.size());
+        unshuffle(shuffled.data(), n, ci.elem, raw.data());
+    } else {
+        AMREX_ALWAYS_ASSERT(ci.nbytes == n*ci.elem);
+        raw = std::move(payload);
+    }
+
+    if (ci.quant == Quant_Uniform) {
+        dequantize(v, n, ci, raw.data());
+    } else {
+        AMREX_ALWAYS_ASSERT(ci.elem == rd.numBytes());
+        if (rd == FPC::NativeRealDescriptor()) {
+            std::memcpy(v, raw.data(), raw.size());
+        } else {
+            RealDescriptor::convertToNativeFormat(v, n, raw.data(), rd);
+        }
+    }
+}
+
+}
+
+void
+lzCompress (char const* src, Long n, Vector<char>& dst)
+{
+    Vector<Long> table(Long(1) << lz_hash_bits, -1);
+
+    auto emit = [&] (Long lit_begin, Long lit_len, Long offset, Long match_len)
+    {
+        const Long ml = (match_len > 0) ? match_len - lz_min_match : 0;
+        const int tl = static_cast<int>(std::min(lit_len, Long(15)));
+        const int tm = static_cast<int>(std::min(ml, Long(15)));
+        dst.push_back(static_cast<char>((tl << 4) | tm));
+        if (lit_len >= 15) { lzPutLength(dst, lit_len-15); }
+        dst.insert(dst.end(), src+lit_begin, src+lit_begin+lit_len);
+        if (match_len > 0) {
+            dst.push_back(static_cast<char>(offset & 0xFF));
+            dst.push_back(static_cast<char>((offset >> 8) & 0xFF));
+            if (ml >= 15) { lzPutLength(dst, ml-15); }
+        }
+    };
+
+    Long anchor = 0;
+    Long ip = 0;
+    const Long limit = n - 8;
+    while (ip < limit) {
+        const std::uint32_t seq = read32(src+ip);
+        auto& slot = table[lzHash(seq)];
+        const Long ref = slot;
+        slot = ip;
+        if (ref >= 0 && ip-ref <= lz_max_offset && read32(src+ref) == seq) {
+            Long len = lz_min_match;
+            while (ip+len < n && src[ref+len] == src[ip+len]) { ++len; }
+            emit(anchor, ip-anchor, ip-ref, len);
+            ip += len;
+            anchor = ip;
+        } else {
+            ++ip;
+        }
+    }
+    // The last sequence has literals only.
+    emit(anchor, n-anchor, 0, 0);
+}
+
+void
+lzDecompress (char const* src, Long nsrc, char* dst, Long n)
+{
+    Long ip = 0, op = 0;
+    while (ip < nsrc) {
+        const auto token = static_cast<unsigned char>(src[ip++]);
+        Long lit_len = token >> 4;
+        if (lit_len == 15) { lit_len += lzGetLength(src, nsrc, ip); }
+        if (ip+lit_len > nsrc || op+lit_len > n) {
+            amrex::Abort("FabCompression: corrupted LZ data");
+        }
+        std::memcpy(dst+op, src+ip, lit_len);
+        ip += lit_len;
+        op += lit_len;
+        if (ip == nsrc) { break; }
+
+        if (ip+2 > nsrc) { amrex::Abort("FabCompression: corrupted LZ data"); }
+        const Long offset = Long(static_cast<unsigned char>(src[ip]))
+            | (Long(static_cast<unsigned char>(src[ip+1])) << 8);
+        ip += 2;
+        Long match_len = token & 15;
+        if (match_len == 15) { match_len += lzGetLength(src, nsrc, ip); }
+        match_len += lz_min_match;
+        if (offset == 0 || offset > op || op+match_len > n) {
+            amrex::Abort("FabCompression: corrupted LZ data");
+        }
+        // The source and destination may overlap.
+        char const* m = dst + op - offset;
+        for (Long i = 0; i < match_len; ++i) {
+            dst[op+i] = m[i];
+        }
+        op += match_len;
+    }
+    if (op != n) { amrex::Abort("FabCompression: corrupted LZ data"); }
+}
+
+void
+encode (Vector<char>& out, Real const* data, Long npts, int ncomp,
+        RealDescriptor const& rd, Real tol)
+{
+    Vector<CompInfo> info(ncomp);
+    Vector<Vector<char>> payload(ncomp);
+    for (int n = 0; n < ncomp; ++n) {
+        encodeComponent(data+n*npts, npts, rd, tol, info[n], payload[n]);
+    }
+
+    std::ostringstream os;
+    os << std::scientific << std::setprecision(17);
+    os << TheCompressedFabPrefix << ' ' << ncomp << ' ' << npts << '\n';
+    for (auto const& ci : info) {
+        os << ci.quant << ' ' << ci.codec << ' ' << ci.elem << ' ' << ci.nbytes << ' '
+           << ci.offset << ' ' << ci.step << '\n';
+    }
+    const std::string hdr = os.str();
+
+    out.clear();
+    out.insert(out.end(), hdr.begin(), hdr.end());
+    for (auto const& p : payload) {
+        out.insert(out.end(), p.begin(), p.end());
+    }
+}
+
+void
+decode (Real* data, Long npts, int ncomp, std::istream& is,
+        RealDescriptor const& rd, int comp)
+{
+    std::string prefix;
+    int nc;
+    Long np;
+    is >> prefix >> nc >> np;
+    if (prefix != TheCompressedFabPrefix || nc != ncomp || np != npts) {
+        amrex::Error("FabCompression::decode: unexpected FAB header");
+    }
+
+    Vector<CompInfo> info(ncomp);
+    for (auto& ci : info) {
+        is >> ci.quant >> ci.codec >> ci.elem >> ci.nbytes >> ci.offset >> ci.step;
+    }
+    if (is.get() != '\n' || !is.good()) {
+        amrex::Error("FabCompression::decode: failed to read FAB header");
+    }
+
+    if (comp < 0) {
+        for (int n = 0; n < ncomp; ++n) {
+            decodeComponent(data+n*npts, npts, rd, info[n], is);
+        }
+    } else {
+        AMREX_ALWAYS_ASSERT(comp < ncomp);
+        Long skip = 0;
+        for (int n = 0; n < comp; ++n) { skip += info[n].nbytes; }
+        is.seekg(skip, std::ios::cur);
+        decodeComponent(data, npts, rd, info[comp], is);
+    }
+}
+
+}
@@ -0,0 +1,239 @@
+#include <AMReX_LoadBalancer.H>
+#include <AMReX_FabArrayBase.H>
+#include <AMReX_GpuDevice.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+namespace amrex {
+
+int LoadBalancer::s_ntiming = 0;
+
+namespace {
+    Vector<LoadBalancer*> timing_balancers;
+}
+
+LoadBalancer::LoadBalancer ()
+{
+    ParmParse pp("loadbalance");
+    pp.queryAdd("smoothing", m_smoothing);
+    pp.queryAdd("min_gain", m_min_gain);
+    pp.queryAdd("max_fac", m_max_fac);
+    pp.queryAdd("verbose", m_verbose);
+    std::string strategy("knapsack");
+    pp.queryAdd("strategy", strategy);
+    if (strategy == "sfc" || strategy == "SFC") {
+        m_strategy = DistributionMapping::SFC;
+    } else if (strategy == "hilbert" || strategy == "HILBERT") {
+        m_strategy = DistributionMapping::HILBERT;
+    } else if (strategy != "knapsack" && strategy != "KNAPSACK") {
+        amrex::Abort("LoadBalancer: unknown loadbalance.strategy " + strategy);
+    }
+    AMREX_ALWAYS_ASSERT(m_smoothing > Real(0.0) && m_smoothing <= Real(1.0));
+}
+
+LoadBalancer::LoadBalancer (const BoxArray& ba, const DistributionMapping& dm)
+    : LoadBalancer()
+{
+    define(ba, dm);
+}
+
+LoadBalancer::~LoadBalancer ()
+{
+    if (m_timing) {
+        timing_balancers.erase(std::find(timing_balancers.begin(), timing_balancers.end(), this));
+        s_ntiming = static_cast<int>(timing_balancers.size());
+    }
+}
+
+void
+LoadBalancer::define (const BoxArray& ba, const DistributionMapping& dm)
+{
+    if (m_ba == ba && m_dm == dm) { return; }
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!m_timing, "LoadBalancer::define: cannot change the grids while timing");
+
+    const auto nboxes = static_cast<int>(ba.size());
+    Vector<Real> cost(nboxes, Real(0.0));
+
+    if (m_nsteps > 0)
+    {
+        // Keep the costs of the boxes in the old grids, and use the mean
+        // cost per cell for the others.
+        Vector<Real> old_cost = m_cost;
+        ParallelDescriptor::ReduceRealSum(old_cost.data(), static_cast<int>(old_cost.size()));
+
+        std::map<Box,int> old_boxes;
+        Real total_cost = 0.0;
+        Long total_pts = 0;
+        for (int i = 0, N = static_cast<int>(m_ba.size()); i < N; ++i) {
+            const Box& bx = m_ba[i];
+            old_boxes.emplace(bx, i);
+            total_cost += old_cost[i];
+            total_pts += bx.numPts();
+        }
+        const Real cost_per_cell = (total_pts > 0) ? total_cost/Real(total_pts) : Real(0.0);
+
+        const int myproc = ParallelDescriptor::MyProc();
+        for (int i = 0; i < nboxes; ++i) {
+            if (dm[i] == myproc) {
+                const Box& bx = ba[i];
+                auto it = old_boxes.find(bx);
+                cost[i] = (it != old_boxes.end()) ? old_cost[it->second]
+                                                  : cost_per_cell * Real(bx.numPts());
+            }
+        }
+    }
+
+    m_ba = ba;
+    m_dm = dm;
+    m_cost = std::move(cost);
+    m_step_cost.assign(nboxes, Real(0.0));
+}
+
+void
+LoadBalancer::startTiming ()
+{
+    AMREX_ALWAYS_ASSERT(!m_timing && !m_ba.empty());
+    m_timing = true;
+    timing_balancers.push_back(this);
+    s_ntiming = static_cast<int>(timing_balancers.size());
+    m_t0 = ParallelDescriptor::second();
+}
+
+void
+LoadBalancer::stopTiming ()
+{
+    AMREX_ALWAYS_ASSERT(m_timing);
+#ifdef AMREX_USE_GPU
+    Gpu::synchronize();
+    // The iterations are not timed on GPUs, so the cost of a box is its
+    // number of cells.
+    const int myproc = ParallelDescriptor::MyProc();
+    for (int i = 0, N = static_cast<int>(m_step_cost.size()); i < N; ++i) {
+        m_step_cost[i] = (m_dm[i] == myproc) ? static_cast<Real>(m_ba[i].numPts()) : Real(0.0);
+    }
+#endif
+    const auto dt = static_cast<Real>(ParallelDescriptor::second() - m_t0);
+    m_timing = false;
+    timing_balancers.erase(std::find(timing_balancers.begin(), timing_balancers.end(), this));
+    s_ntiming = static_cast<int>(timing_balancers.size());
+
+    const Real a = (m_nsteps == 0) ? Real(1.0) : m_smoothing;
+    for (int i = 0, N = static_cast<int>(m_cost.size()); i < N; ++i) {
+        m_cost[i] = (Real(1.0)-a)*m_cost[i] + a*m_step_cost[i];
+        m_step_cost[i] = Real(0.0);
+    }
+    m_time = (Real(1.0)-a)*m_time + a*dt;
+
+    ++m_nsteps;
+    ++m_nsteps_since;
+}
+
+bool
+LoadBalancer::rebalance (DistributionMapping& new_dm)
+{
+    return rebalance(new_dm, m_nsteps_since);
+}
+
+bool
+LoadBalancer::rebalance (DistributionMapping& new_dm, int nsteps)
+{
+    BL_PROFILE("LoadBalancer::rebalance()");
+
+    AMREX_ALWAYS_ASSERT(!m_timing);
+
+    m_nsteps_since = 0;
+
+    const int nprocs = ParallelDescriptor::NProcs();
+    if (m_nsteps == 0 || nprocs == 1 || nsteps <= 0) { return false; }
+
+    Vector<Real> cost = m_cost;
+    ParallelDescriptor::ReduceRealSum(cost.data(), static_cast<int>(cost.size()));
+
+    Real step_time = m_time;
+    ParallelDescriptor::ReduceRealMax(step_time);
+
+    if (*std::max_element(cost.begin(), cost.end()) <= Real(0.0)) { return false; }
+
+    DistributionMapping::ComputeDistributionMappingEfficiency(m_dm, cost, &m_current_eff);
+
+    DistributionMapping dm;
+    if (m_strategy == DistributionMapping::SFC) {
+        dm = DistributionMapping::makeSFC(cost, m_ba, m_proposed_eff);
+    } else if (m_strategy == DistributionMapping::HILBERT) {
+        dm = DistributionMapping::makeHilbert(cost, m_ba, m_proposed_eff);
+    } else {
+        Real navg = static_cast<Real>(m_ba.size()) / static_cast<Real>(nprocs);
+        int nmax = static_cast<int>(std::max(std::round(m_max_fac*navg), std::ceil(navg)));
+        dm = DistributionMapping::makeKnapSack(cost, m_proposed_eff, nmax);
+    }
+
+    // With the maximum load proportional to 1/efficiency, the time of a
+    // step is predicted to be scaled by current_eff/proposed_eff.
+    const Real saving = Real(nsteps) * step_time * (Real(1.0) - m_current_eff/m_proposed_eff);
+    const Real redist_time = (m_redist_time >= Real(0.0)) ? m_redist_time : step_time;
+
+    const bool r = (dm != m_dm)
+        && (m_proposed_eff > (Real(1.0)+m_min_gain)*m_current_eff)
+        && (saving > redist_time);
+
+    if (m_verbose) {
+        amrex::Print() << "LoadBalancer: efficiency " << m_current_eff << " -> " << m_proposed_eff
+                       << ", predicted saving " << saving << " s over " << nsteps
+                       << " steps, redistribution " << redist_time << " s, "
+                       << (r ? "rebalance" : "keep") << "\n";
+    }
+
+    if (r) {
+        const int myproc = ParallelDescriptor::MyProc();
+        for (int i = 0, N = static_cast<int>(cost.size()); i < N; ++i) {
+            m_cost[i] = (dm[i] == myproc) ? cost[i] : Real(0.0);
+        }
+        m_dm = dm;
+        new_dm = dm;
+    }
+
+    return r;
+}
+
+void
+LoadBalancer::setRedistributionTime (Real t)
+{
+    ParallelDescriptor::ReduceRealMax(t);
+    m_redist_time = t;
+}
+
+void
+LoadBalancer::setCosts (const Vector<Real>& cost, Real step_time)
+{
+    AMREX_ALWAYS_ASSERT(!m_timing && cost.size() == m_cost.size());
+    const int myproc = ParallelDescriptor::MyProc();
+    for (int i = 0, N = static_cast<int>(cost.size()); i < N; ++i) {
+        m_cost[i] = (m_dm[i] == myproc) ? cost[i] : Real(0.0);
+    }
+    m_time = step_time;
+    m_nsteps = std::max(m_nsteps, 1);
+}
+
+Real*
+LoadBalancer::timedCosts ([[maybe_unused]] const FabArrayBase& fa) noexcept
+{
+#ifdef AMREX_USE_GPU
+    // Timing each iteration would need a device synchronization.
+    return nullptr;
+#else
+    for (auto* lb : timing_balancers) {
+        if (fa.DistributionMap() == lb->m_dm && fa.boxArray().CellEqual(lb->m_ba)) {
+            return lb->m_step_cost.data();
+        }
+    }
+    return nullptr;
+#endif
+}
+
+}
@@ -2,6 +2,7 @@
 #include <AMReX_MFIter.H>
 #include <AMReX_FabArray.H>
 #include <AMReX_FArrayBox.H>
+#include <AMReX_LoadBalancer.H>
 #include <AMReX_OpenMP.H>
 
 namespace amrex {
@@ -230,6 +231,11 @@ MFIter::Finalize ()
     if (finalized) { return; }
     finalized = true;
 
+    if (cost_timer.costs && currentIndex < endIndex) {
+        recordCost();
+    }
+    cost_timer.costs = nullptr;
+
     // mark as invalid
     currentIndex = endIndex;
 
@@ -379,6 +385,26 @@ MFIter::Initialize ()
 
         typ = fabArray->boxArray().ixType();
     }
+
+    if (LoadBalancer::numTiming() > 0) {
+        cost_timer.costs = LoadBalancer::timedCosts(*fabArray);
+        if (cost_timer.costs) {
+            cost_timer.t0 = ParallelDescriptor::second();
+        }
+    }
+}
+
+void
+MFIter::recordCost () noexcept
+{
+    const double t = ParallelDescriptor::second();
+    Real& cost = cost_timer.costs[(*index_map)[currentIndex]];
+    const auto dt = static_cast<Real>(t - cost_timer.t0);
+#ifdef AMREX_USE_OMP
+#pragma omp atomic
+#endif
+    cost += dt;
+    cost_timer.t0 = t;
 }
 
 Box
@@ -521,6 +547,10 @@ MFIter::grownnodaltilebox (int dir, IntVect const& a_ng) const noexcept
 void
 MFIter::operator++ () noexcept
 {
+    if (cost_timer.costs && currentIndex < endIndex) {
+        recordCost();
+    }
+
 #ifdef AMREX_USE_OMP
     if (dynamic)
     {
@@ -1,5 +1,6 @@
 #include <AMReX_Machine.H>
 #include <AMReX.H>
+#include <AMReX_ParallelDescriptor.H>
 #include <AMReX_String.H>
 
 #include <cstdlib>
@@ -9,6 +10,42 @@ namespace amrex::Machine
 
 namespace {
     std::string s_name;
+    Vector<int> s_node_of_rank;
+    int s_num_nodes = 1;
+
+    void find_nodes ()
+    {
+        const int nprocs = ParallelDescriptor::NProcs();
+        s_node_of_rank.assign(nprocs, 0);
+        s_num_nodes = 1;
+#ifdef AMREX_USE_MPI
+        if (nprocs > 1) {
+#if defined(OPEN_MPI)
+            int split_type = OMPI_COMM_TYPE_NODE;
+#else
+            int split_type = MPI_COMM_TYPE_SHARED;
+#endif
+            // A node is identified by its lowest rank.
+            MPI_Comm node_comm;
+            MPI_Comm_split_type(ParallelDescriptor::Communicator(), split_type, 0,
+                                MPI_INFO_NULL, &node_comm);
+            int leader = ParallelDescriptor::MyProc();
+            MPI_Allreduce(MPI_IN_PLACE, &leader, 1, MPI_INT, MPI_MIN, node_comm);
+            MPI_Comm_free(&node_comm);
+            Vector<int> leaders(nprocs);
+            MPI_Allgather(&leader, 1, MPI_INT, leaders.data(), 1, MPI_INT,
+                          ParallelDescriptor::Communicator());
+            Vector<int> node_of_leader(nprocs, -1);
+            s_num_nodes = 0;
+            for (int i = 0; i < nprocs; ++i) {
+                if (node_of_leader[leaders[i]] < 0) {
+                    node_of_leader[leaders[i]] = s_num_nodes++;
+                }
+                s_node_of_rank[i] = node_of_leader[leaders[i]];
+            }
+        }
+#endif
+    }
 }
 
 void Initialize ()
@@ -38,14 +75,30 @@ void Initialize ()
         s_name = amrex::toLower(std::move(s_name));
     }
 
+    find_nodes();
+
     amrex::ExecOnFinalize(Machine::Finalize);
 }
 
-void Finalize () {}
+void Finalize ()
+{
+    s_node_of_rank.clear();
+    s_num_nodes = 1;
+}
 
 std::string const& name ()
 {
     return s_name;
 }
 
+Vector<int> const& nodeOfRank ()
+{
+    return s_node_of_rank;
+}
+
+int numNodes ()
+{
+    return s_num_nodes;
+}
+
 }
@@ -147,4 +147,26 @@ PlotFileDataImpl::get (int level, std::string const& varname) noexcept
     return mf;
 }
 
+FArrayBox
+PlotFileDataImpl::get (int level, Box const& box, int comp, int ncomp) noexcept
+{
+    FArrayBox fab(box, ncomp, The_Pinned_Arena());
+    fab.setVal<RunOn::Host>(0.0);
+    m_vismf[level]->readRegion(fab, comp);
+    return fab;
+}
+
+FArrayBox
+PlotFileDataImpl::get (int level, Box const& box, std::string const& varname) noexcept
+{
+    auto r = std::find(std::begin(m_var_names), std::end(m_var_names), varname);
+    if (r == std::end(m_var_names)) {
+        amrex::Abort("PlotFileDataImpl::get: varname not found "+varname);
+        return FArrayBox{};
+    } else {
+        int icomp = static_cast<int>(std::distance(std::begin(m_var_names), r));
+        return get(level, box, icomp);
+    }
+}
+
 }
@@ -0,0 +1,313 @@
+
+#include <AMReX_TArena.H>
+#include <AMReX_OpenMP.H>
+#include <AMReX_ParallelReduce.H>
+#include <AMReX_Print.H>
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+namespace amrex {
+
+namespace {
+    std::mutex& slot_mutex ()
+    {
+        static std::mutex m;
+        return m;
+    }
+
+    //! Slots released by threads that have exited
+    std::vector<int>& free_slots ()
+    {
+        static std::vector<int> v;
+        return v;
+    }
+
+    int s_num_slots = 0;
+
+    //! A slot is taken when a thread first uses a TArena, and is given back
+    //! when the thread exits, so that threads created later can reuse it.
+    struct ThreadSlot
+    {
+        ThreadSlot ()
+        {
+            std::lock_guard<std::mutex> lock(slot_mutex());
+            auto& fs = free_slots();
+            if (fs.empty()) {
+                slot = s_num_slots++;
+            } else {
+                // The smallest slot is reused first.
+                std::pop_heap(fs.begin(), fs.end(), std::greater<>());
+                slot = fs.back();
+                fs.pop_back();
+            }
+        }
+
+        ~ThreadSlot ()
+        {
+            std::lock_guard<std::mutex> lock(slot_mutex());
+            auto& fs = free_slots();
+            fs.push_back(slot);
+            std::push_heap(fs.begin(), fs.end(), std::greater<>());
+        }
+
+        ThreadSlot (ThreadSlot const&) = delete;
+        ThreadSlot (ThreadSlot &&) = delete;
+        ThreadSlot& operator= (ThreadSlot const&) = delete;
+        ThreadSlot& operator= (ThreadSlot &&) = delete;
+
+        int slot = 0;
+    };
+
+    //! Index of the calling thread among the live threads
+    int thread_slot ()
+    {
+        thread_local ThreadSlot ts;
+        return ts.slot;
+    }
+}
+
+TArena::TArena (std::size_t cache_size, ArenaInfo info)
+    : m_pool(0, info),
+      m_cache_size(cache_size == 0 ? DefaultCacheSize : cache_size),
+      m_ncaches(std::max(2*OpenMP::get_max_threads(), 8)),
+      m_caches(std::make_unique<ThreadCache[]>(m_ncaches))
+{
+    arena_info = info;
+    static_assert(header_size == Arena::align_size, "TArena: wrong header size");
+}
+
+TArena::~TArena () = default;
+
+int
+TArena::sizeClass (std::size_t nbytes) noexcept
+{
+    if (nbytes > MaxCachedSize) { return -1; }
+    if (nbytes <= 64) { return 0; }
+    // nbytes is in (2^e, 2^(e+1)], which is split into four classes.
+    const std::size_t m = nbytes - 1;
+    int e = 6;
+    while ((m >> (e+1)) != 0) { ++e; }
+    const auto sub = static_cast<int>((m - (std::size_t(1) << e)) >> (e-2));
+    return (e-6)*4 + sub + 1;
+}
+
+std::size_t
+TArena::classSize (int c) noexcept
+{
+    if (c == 0) { return 64; }
+    const int e = (c-1)/4 + 6;
+    const int sub = (c-1)%4;
+    return (std::size_t(1) << e) + std::size_t(sub+1) * (std::size_t(1) << (e-2));
+}
+
+TArena::ThreadCache*
+TArena::myCache () noexcept
+{
+    const int i = thread_slot();
+    return (i < m_ncaches) ? &m_caches[i] : nullptr;
+}
+
+void*
+TArena::alloc (std::size_t nbytes)
+{
+    std::size_t sz = Arena::align(nbytes == 0 ? 1 : nbytes) + header_size;
+    const int sc = sizeClass(sz);
+
+    Header* h = nullptr;
+    ThreadCache* c = myCache();
+
+    if (sc >= 0) {
+        sz = classSize(sc);
+        if (c) {
+            while (c->busy.test_and_set(std::memory_order_acquire)) {}
+            h = c->free_list[sc];
+            if (h) {
+                c->free_list[sc] = h->next;
+                c->cached.fetch_sub(static_cast<Long>(sz), std::memory_order_relaxed);
+            }
+            c->busy.clear(std::memory_order_release);
+        }
+    }
+
+    if (h == nullptr) {
+        h = static_cast<Header*>(m_pool.alloc(sz));
+        h->size = sz;
+    }
+
+    if (c) {
+        c->used.fetch_add(static_cast<Long>(sz), std::memory_order_relaxed);
+    } else {
+        m_used_uncached.fetch_add(static_cast<Long>(sz), std::memory_order_relaxed);
+    }
+
+    profile_alloc(h, sz);
+
+    return reinterpret_cast<char*>(h) + header_size;
+}
+
+void
+TArena::free (void* vp)
+{
+    if (vp == nullptr) {
+        //
+        // Allow calls with NULL as allowed by C++ delete.
+        //
+        return;
+    }
+
+    auto* h = reinterpret_cast<Header*>(static_cast<char*>(vp) - header_size);
+    const std::size_t sz = h->size;
+
+    profile_free(h, sz);
+
+    ThreadCache* c = myCache();
+
+    if (c) {
+        c->used.fetch_sub(static_cast<Long>(sz), std::memory_order_relaxed);
+    } else {
+        m_used_uncached.fetch_sub(static_cast<Long>(sz), std::memory_order_relaxed);
+    }
+
+    const int sc = sizeClass(sz);
+    if (c && sc >= 0) {
+        while (c->busy.test_and_set(std::memory_order_acquire)) {}
+        h->next = c->free_list[sc];
+        c->free_list[sc] = h;
+        auto cached = c->cached.fetch_add(static_cast<Long>(sz), std::memory_order_relaxed)
+            + static_cast<Long>(sz);
+        if (cached > static_cast<Long>(m_cache_size)) {
+            flush(*c, m_cache_size/2);
+        }
+        c->busy.clear(std::memory_order_release);
+    } else {
+        m_pool.free(h);
+    }
+}
+
+void
+TArena::flush (ThreadCache& c, std::size_t nbytes)
+{
+    // The largest blocks go first.
+    for (int sc = NumSizeClasses-1; sc >= 0; --sc) {
+        if (c.cached.load(std::memory_order_relaxed) <= static_cast<Long>(nbytes)) { break; }
+        const auto sz = static_cast<Long>(classSize(sc));
+        while (c.free_list[sc] && c.cached.load(std::memory_order_relaxed) > static_cast<Long>(nbytes)) {
+            Header* h = c.free_list[sc];
+            c.free_list[sc] = h->next;
+            c.cached.fetch_sub(sz, std::memory_order_relaxed);
+            m_pool.free(h);
+        }
+    }
+}
+
+std::size_t
+TArena::freeUnused ()
+{
+    return freeUnused_protected();
+}
+
+std::size_t
+TArena::freeUnused_protected ()
+{
+    for (int i = 0; i < m_ncaches; ++i) {
+        ThreadCache& c = m_caches[i];
+        while (c.busy.test_and_set(std::memory_order_acquire)) {}
+        flush(c, 0);
+        c.busy.clear(std::memory_order_release);
+    }
+    return m_pool.freeUnused();
+}
+
+void
+TArena::profile_alloc ([[maybe_unused]] Header* h, [[maybe_unused]] std::size_t nbytes)
+{
+    h->stat = nullptr;
+#ifdef AMREX_TINY_PROFILING
+    if (m_profiler.m_do_profiling) {
+        std::lock_guard<std::mutex> lock(m_profiler.m_arena_profiler_mutex);
+        h->stat = TinyProfiler::memory_alloc(nbytes, m_profiler.m_profiling_stats);
+    }
+#endif
+}
+
+void
+TArena::profile_free ([[maybe_unused]] Header* h, [[maybe_unused]] std::size_t nbytes)
+{
+#ifdef AMREX_TINY_PROFILING
+    if (h->stat) {
+        std::lock_guard<std::mutex> lock(m_profiler.m_arena_profiler_mutex);
+        TinyProfiler::memory_free(nbytes, h->stat);
+    }
+#endif
+}
+
+std::size_t
+TArena::heap_space_used () const noexcept
+{
+    return m_pool.heap_space_used();
+}
+
+std::size_t
+TArena::heap_space_actually_used () const noexcept
+{
+    Long r = m_used_uncached.load(std::memory_order_relaxed);
+    for (int i = 0; i < m_ncaches; ++i) {
+        r += m_caches[i].used.load(std::memory_order_relaxed);
+    }
+    return static_cast<std::size_t>(std::max(r, Long(0)));
+}
+
+std::size_t
+TArena::heap_space_cached () const noexcept
+{
+    Long r = 0;
+    for (int i = 0; i < m_ncaches; ++i) {
+        r += m_caches[i].cached.load(std::memory_order_relaxed);
+    }
+    return static_cast<std::size_t>(r);
+}
+
+void
+TArena::PrintUsage (std::string const& name) const
+{
+    Long min_megabytes = static_cast<Long>(heap_space_used() / (1024*1024));
+    Long max_megabytes = min_megabytes;
+    Long actual_min_megabytes = static_cast<Long>(heap_space_actually_used() / (1024*1024));
+    Long actual_max_megabytes = actual_min_megabytes;
+    Long cached_min_megabytes = static_cast<Long>(heap_space_cached() / (1024*1024));
+    Long cached_max_megabytes = cached_min_megabytes;
+    const int IOProc = ParallelDescriptor::IOProcessorNumber();
+    ParallelReduce::Min<Long>({min_megabytes, actual_min_megabytes, cached_min_megabytes},
+                              IOProc, ParallelDescriptor::Communicator());
+    ParallelReduce::Max<Long>({max_megabytes, actual_max_megabytes, cached_max_megabytes},
+                              IOProc, ParallelDescriptor::Communicator());
+#ifdef AMREX_USE_MPI
+    amrex::Print() << "[" << name << "] space (MB) allocated spread across MPI: ["
+                   << min_megabytes << " ... " << max_megabytes << "]\n"
+                   << "[" << name << "] space (MB) used      spread across MPI: ["
+                   << actual_min_megabytes << " ... " << actual_max_megabytes << "]\n"
+                   << "[" << name << "] space (MB) cached    spread across MPI: ["
+                   << cached_min_megabytes << " ... " << cached_max_megabytes << "]\n";
+#else
+    amrex::Print() << "[" << name << "] space allocated (MB): " << min_megabytes << "\n";
+    amrex::Print() << "[" << name << "] space used      (MB): " << actual_min_megabytes << "\n";
+    amrex::Print() << "[" << name << "] space cached    (MB): " << cached_min_megabytes << "\n";
+#endif
+}
+
+void
+TArena::PrintUsage (std::ostream& os, std::string const& name, std::string const& space) const
+{
+    auto megabytes = heap_space_used() / (1024*1024);
+    auto actual_megabytes = heap_space_actually_used() / (1024*1024);
+    auto cached_megabytes = heap_space_cached() / (1024*1024);
+    os << space << "[" << name << "] space allocated (MB): " << megabytes << "\n";
+    os << space << "[" << name << "] space used      (MB): " << actual_megabytes << "\n";
+    os << space << "[" << name << "] space cached    (MB): " << cached_megabytes << "\n";
+}
+
+}
@@ -1,7 +1,9 @@
 
 #include <AMReX_FabArrayUtility.H>
+#include <AMReX_FabCompression.H>
 #include <AMReX_FPC.H>
 #include <AMReX_IOFormat.H>
+#include <AMReX_ParallelReduce.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_Utility.H>
 #include <AMReX_VisMF.H>
@@ -9,9 +11,17 @@
 #include <cerrno>
 #include <cstdio>
 #include <limits>
+#include <streambuf>
 #include <vector>
 #include <utility>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace amrex {
 
 namespace {
@@ -24,6 +34,7 @@ std::map<std::string, VisMF::PersistentIFStream> VisMF::persistentIFStreams;
 
 int VisMF::verbose(0);
 VisMF::Header::Version VisMF::currentVersion(VisMF::Header::Version_v1);
+Real VisMF::compressionTolerance(0);
 bool VisMF::groupSets(false);
 bool VisMF::setBuf(true);
 bool VisMF::useSingleRead(false);
@@ -127,6 +138,7 @@ VisMF::Initialize ()
       currentVersion = static_cast<VisMF::Header::Version> (headerVersion);
     }
 
+    pp.query("compression_tolerance", compressionTolerance);
     pp.query("groupsets", groupSets);
     pp.query("setbuf", setBuf);
     pp.query("usesingleread", useSingleRead);
@@ -344,7 +356,9 @@ operator<< (std::ostream        &os,
       os << hd.m_max      << '\n';
     }
 
-    if(hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1) {
+    if(hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 ||
+       hd.m_vers == VisMF::Header::Compressed_v1)
+    {
       BL_ASSERT(hd.m_famin.size() == hd.m_ncomp);
       BL_ASSERT(hd.m_famin.size() == hd.m_famax.size());
       for(auto famin : hd.m_famin) {
@@ -357,9 +371,10 @@ operator<< (std::ostream        &os,
       os << '\n';
     }
 
-    if(hd.m_vers == VisMF::Header::NoFabHeader_v1       ||
-       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
-       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1)
+    if(hd.m_vers == VisMF::Header::NoFabHeader_v1         ||
+       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1   ||
+       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 ||
+       hd.m_vers == VisMF::Header::Compressed_v1)
     {
       if(FArrayBox::getFormat() == FABio::FAB_NATIVE) {
         os << FPC::NativeRealDescriptor() << '\n';
@@ -427,7 +442,9 @@ operator>> (std::istream  &is,
       BL_ASSERT(hd.m_ba.size() == hd.m_max.size());
     }
 
-    if(hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1) {
+    if(hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 ||
+       hd.m_vers == VisMF::Header::Compressed_v1)
+    {
       char ch;
       AMREX_ASSERT(hd.m_ncomp >= 0 && hd.m_ncomp < std::numeric_limits<int>::max());
       hd.m_famin.resize(hd.m_ncomp);
@@ -445,9 +462,10 @@ operator>> (std::istream  &is,
         }
       }
     }
-    if(hd.m_vers == VisMF::Header::NoFabHeader_v1       ||
-       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
-       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1)
+    if(hd.m_vers == VisMF::Header::NoFabHeader_v1         ||
+       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1   ||
+       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 ||
+       hd.m_vers == VisMF::Header::Compressed_v1)
     {
       is >> hd.m_writtenRD;
     }
@@ -599,6 +617,167 @@ VisMF::readFAB (int idx, int icomp)
     return VisMF::readFAB(idx, m_fafabname, m_hdr, icomp);
 }
 
+namespace {
+#ifndef _WIN32
+    // Read-only memory mapping of a whole file
+    class MappedFile
+    {
+    public:
+        explicit MappedFile (std::string const& name)
+        {
+            int fd = ::open(name.c_str(), O_RDONLY);
+            if (fd < 0) { amrex::FileOpenFailed(name); }
+            struct stat st{};
+            if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+                m_size = static_cast<std::size_t>(st.st_size);
+                void* p = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+                if (p == MAP_FAILED) {
+                    ::close(fd);
+                    amrex::Error("VisMF: failed to mmap " + name);
+                }
+                m_data = static_cast<char*>(p);
+            }
+            ::close(fd);
+        }
+
+        ~MappedFile () { if (m_data) { ::munmap(m_data, m_size); } }
+
+        MappedFile (MappedFile const&) = delete;
+        MappedFile (MappedFile &&) = delete;
+        MappedFile& operator= (MappedFile const&) = delete;
+        MappedFile& operator= (MappedFile &&) = delete;
+
+        [[nodiscard]] char* data () const { return m_data; }
+        [[nodiscard]] std::size_t size () const { return m_size; }
+
+    private:
+        char* m_data = nullptr;
+        std::size_t m_size = 0;
+    };
+
+    // Input stream buffer over a block of memory
+    class MemoryStreamBuf
+        : public std::streambuf
+    {
+    public:
+        MemoryStreamBuf (char* p, std::size_t n) { setg(p, p, p+n); }
+
+        [[nodiscard]] std::size_t position () const { return gptr() - eback(); }
+
+    protected:
+        pos_type seekoff (off_type off, std::ios_base::seekdir dir,
+                          std::ios_base::openmode /*which*/) override
+        {
+            char* p = (dir == std::ios_base::beg) ? eback()
+                    : (dir == std::ios_base::cur) ? gptr() : egptr();
+            p += off;
+            if (p < eback() || p > egptr()) { return pos_type(off_type(-1)); }
+            setg(eback(), p, egptr());
+            return pos_type(p - eback());
+        }
+
+        pos_type seekpos (pos_type pos, std::ios_base::openmode which) override
+        {
+            return seekoff(off_type(pos), std::ios_base::beg, which);
+        }
+    };
+#endif
+}
+
+void
+VisMF::readRegion (FArrayBox& fab, int icomp) const
+{
+    const Box& region = fab.box();
+    const int ncomp = fab.nComp();
+    AMREX_ALWAYS_ASSERT(icomp >= 0 && icomp+ncomp <= m_hdr.m_ncomp);
+
+    for (auto const& [idx, bx] : m_hdr.m_ba.intersections(region)) {
+        readFABRegion(fab, 0, bx, idx, icomp, ncomp);
+    }
+}
+
+void
+VisMF::readFABRegion (FArrayBox& fab, int dcomp, const Box& bx,
+                      int idx, int icomp, int ncomp) const
+{
+    // Read whole components through the stream interface.
+    auto read_components = [&] ()
+    {
+        for (int n = 0; n < ncomp; ++n) {
+            std::unique_ptr<FArrayBox> src(VisMF::readFAB(idx, m_fafabname, m_hdr, icomp+n));
+            fab.copy<RunOn::Host>(*src, bx, 0, bx, dcomp+n, 1);
+        }
+    };
+
+#ifdef _WIN32
+    read_components();
+#else
+    std::string FullName(VisMF::DirName(m_fafabname));
+    FullName += m_hdr.m_fod[idx].m_name;
+
+    auto& mapped = m_mapped_files[FullName];
+    if (!mapped) { mapped = std::make_shared<MappedFile>(FullName); }
+    auto const& mfile = *static_cast<MappedFile const*>(mapped.get());
+
+    const Long head = m_hdr.m_fod[idx].m_head;
+    AMREX_ALWAYS_ASSERT(head >= 0 && static_cast<std::size_t>(head) <= mfile.size());
+    MemoryStreamBuf sbuf(mfile.data()+head, mfile.size()-head);
+    std::istream is(&sbuf);
+
+    Box fab_box = amrex::grow(m_hdr.m_ba[idx], m_hdr.m_ngrow);
+    RealDescriptor rd = m_hdr.m_writtenRD;
+
+    if (m_hdr.m_vers == Header::Version_v1) {
+        char c[4];
+        is >> c[0] >> c[1] >> c[2] >> c[3];
+        if (c[0] != 'F' || c[1] != 'A' || c[2] != 'B' || c[3] == ':') {
+            // Not a FAB in the current binary format
+            read_components();
+            return;
+        }
+        is.putback(c[3]);
+        int nvar;
+        is >> rd >> fab_box >> nvar;
+        is.ignore(BL_IGNORE_MAX, '\n');
+        if (is.fail()) { amrex::Error("VisMF::readRegion: failed to read FAB header"); }
+    }
+
+    AMREX_ASSERT(fab_box.contains(bx) && fab.box().contains(bx));
+
+    if (m_hdr.m_vers == Header::Compressed_v1) {
+        // Only the requested components are decoded.
+        FArrayBox tmp(fab_box, 1, The_Cpu_Arena());
+        for (int n = 0; n < ncomp; ++n) {
+            is.clear();
+            is.seekg(0, std::ios::beg);
+            FabCompression::decode(tmp.dataPtr(), fab_box.numPts(), m_hdr.m_ncomp,
+                                   is, rd, icomp+n);
+            fab.copy<RunOn::Host>(tmp, bx, 0, bx, dcomp+n, 1);
+        }
+    } else {
+        // Convert the rows of bx only. The other pages are never touched.
+        char* data = mfile.data() + head + sbuf.position();
+        const auto nbytes = static_cast<Long>(rd.numBytes());
+        const Long npts = fab_box.numPts();
+        AMREX_ALWAYS_ASSERT(static_cast<std::size_t>(head) + sbuf.position()
+                            + m_hdr.m_ncomp*npts*nbytes <= mfile.size());
+        const Box& dst_box = fab.box();
+        const auto lo = amrex::lbound(bx);
+        const auto hi = amrex::ubound(bx);
+        const Long nx = hi.x - lo.x + 1;
+        for (int n = 0; n < ncomp; ++n) {
+            char* src = data + (icomp+n)*npts*nbytes;
+            for (int k = lo.z; k <= hi.z; ++k) {
+            for (int j = lo.y; j <= hi.y; ++j) {
+                IntVect iv(AMREX_D_DECL(lo.x,j,k));
+                RealDescriptor::convertToNativeFormat(fab.dataPtr(dcomp+n) + dst_box.index(iv), nx,
+                                                      src + fab_box.index(iv)*nbytes, rd);
+            }}
+        }
+    }
+#endif
+}
+
 std::string
 VisMF::BaseName (const std::string& filename)
 {
@@ -706,7 +885,7 @@ VisMF::Header::Header (const FabArray<FArrayBox>& mf,
         && (mf.arena()->isManaged() || mf.arena()->isDevice());
     amrex::ignore_unused(run_on_device);
 
-    if(version == NoFabHeaderFAMinMax_v1) {
+    if(version == NoFabHeaderFAMinMax_v1 || version == Compressed_v1) {
       // ---- calculate FabArray min max values only
       m_min.clear();
       m_max.clear();
@@ -1040,12 +1219,57 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
 
     bool oldHeader(currentVersion == VisMF::Header::Version_v1);
 
+    // ---- compress the fabs before taking turns writing them
+    bool compressed(currentVersion == VisMF::Header::Compressed_v1);
+    Vector<Vector<char> > compressedFabs;
+    Vector<Long> fabBytes;
+    if(compressed) {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(FArrayBox::getFormat() != FABio::FAB_ASCII &&
+                                         FArrayBox::getFormat() != FABio::FAB_8BIT,
+                                         "VisMF::Write: Compressed_v1 requires a binary FAB format");
+        const int nlocal = mf.local_size();
+        compressedFabs.resize(nlocal);
+        fabBytes.resize(mf.size(), 0);
+        Vector<std::unique_ptr<FArrayBox> > hostfabs(nlocal);
+#ifdef AMREX_USE_GPU
+        if (mf.arena()->isManaged() || mf.arena()->isDevice()) {
+            for(int li = 0; li < nlocal; ++li) {
+                const FArrayBox &fab = mf[mf.IndexArray()[li]];
+                hostfabs[li] = std::make_unique<FArrayBox>(fab.box(), fab.nComp(),
+                                                           The_Pinned_Arena());
+                Gpu::dtoh_memcpy_async(hostfabs[li]->dataPtr(), fab.dataPtr(),
+                                       fab.size()*sizeof(Real));
+            }
+            Gpu::streamSynchronize();
+        }
+#endif
+#ifdef AMREX_USE_OMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for(int li = 0; li < nlocal; ++li) {
+            const int idx = mf.IndexArray()[li];
+            const FArrayBox &fab = hostfabs[li] ? *hostfabs[li] : mf[idx];
+            FabCompression::encode(compressedFabs[li], fab.dataPtr(), fab.box().numPts(),
+                                   fab.nComp(), *whichRD, compressionTolerance);
+            fabBytes[idx] = static_cast<Long>(compressedFabs[li].size());
+        }
+    }
+
     if(useSparseFPP) {
         nfi.SetSparseFPP(procsWithDataVector);
     } else if(useDynamicSetSelection) {
         nfi.SetDynamic();
     }
     for( ; nfi.ReadyToWrite(); ++nfi) {
+        if(compressed) {
+            for(const auto &cfab : compressedFabs) {
+                nfi.Stream().write(cfab.data(), static_cast<std::streamsize>(cfab.size()));
+                bytesWritten += static_cast<Long>(cfab.size());
+            }
+            nfi.Stream().flush();
+            continue;
+        }
+
         // ---- find the total number of bytes including fab headers if needed
         const FABio &fio = FArrayBox::getFABio();
         int whichRDBytes(whichRD->numBytes()), nFABs(0);
@@ -1164,7 +1388,8 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
     }
 
     VisMF::FindOffsets(mf, filePrefix, hdr, currentVersion, nfi,
-                       ParallelDescriptor::Communicator());
+                       ParallelDescriptor::Communicator(),
+                       compressed ? &fabBytes : nullptr);
 
     bytesWritten += VisMF::WriteHeader(mf_name, hdr, coordinatorProc);
 
@@ -1211,7 +1436,8 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
                     const std::string &filePrefix,
                     VisMF::Header &hdr,
                     VisMF::Header::Version /*whichVersion*/,
-                    NFilesIter &nfi, MPI_Comm comm)
+                    NFilesIter &nfi, MPI_Comm comm,
+                    Vector<Long> const* fabBytes)
 {
 //    BL_PROFILE("VisMF::FindOffsets");
 
@@ -1297,6 +1523,14 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
       int whichRDBytes(whichRD->numBytes());
       int nComps(mf.nComp());
 
+      // ---- the sizes of compressed fabs are only known where they were written
+      Vector<Long> allFabBytes;
+      if(fabBytes != nullptr) {
+        allFabBytes = *fabBytes;
+        ParallelReduce::Sum(allFabBytes.dataPtr(), static_cast<int>(allFabBytes.size()),
+                            coordinatorProc, comm);
+      }
+
       if(myProc == coordinatorProc) {   // ---- calculate offsets
         const BoxArray &mfBA = mf.boxArray();
         const DistributionMapping &mfDM = mf.DistributionMap();
@@ -1352,8 +1586,12 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
               for(int i : index) {
                  hdr.m_fod[i].m_name = whichFileName;
                  hdr.m_fod[i].m_head = currentOffset[whichFileNumber];
-                 currentOffset[whichFileNumber] += mf.fabbox(i).numPts() * nComps * whichRDBytes
-                                                   + fabHeaderBytes[i];
+                 if(fabBytes != nullptr) {
+                   currentOffset[whichFileNumber] += allFabBytes[i];
+                 } else {
+                   currentOffset[whichFileNumber] += mf.fabbox(i).numPts() * nComps * whichRDBytes
+                                                     + fabHeaderBytes[i];
+                 }
               }
             }
           }
@@ -1453,7 +1691,10 @@ VisMF::readFAB (int                  idx,
           fabdata = hostfab->dataPtr();
       }
 #endif
-      if(whichComp == -1) {    // ---- read all components
+      if(hdr.m_vers == Header::Compressed_v1) {
+        FabCompression::decode(fabdata, fab->box().numPts(), hdr.m_ncomp, *infs,
+                               hdr.m_writtenRD, whichComp);
+      } else if(whichComp == -1) {    // ---- read all components
         if(hdr.m_writtenRD == FPC::NativeRealDescriptor()) {
           infs->read((char *) fabdata, static_cast<std::streamsize>(fab->nBytes()));
         } else {
@@ -1502,7 +1743,7 @@ VisMF::readFAB (FabArray<FArrayBox> &mf,
     std::ifstream *infs = VisMF::OpenStream(FullName);
     infs->seekg(hdr.m_fod[idx].m_head, std::ios::beg);
 
-    if(NoFabHeader(hdr)) {
+    if(NoFabHeader(hdr) || hdr.m_vers == Header::Compressed_v1) {
       Real* fabdata = fab.dataPtr();
 #ifdef AMREX_USE_GPU
       std::unique_ptr<FArrayBox> hostfab;
@@ -1511,7 +1752,10 @@ VisMF::readFAB (FabArray<FArrayBox> &mf,
           fabdata = hostfab->dataPtr();
       }
 #endif
-      if(hdr.m_writtenRD == FPC::NativeRealDescriptor()) {
+      if(hdr.m_vers == Header::Compressed_v1) {
+        FabCompression::decode(fabdata, fab.box().numPts(), fab.nComp(), *infs,
+                               hdr.m_writtenRD);
+      } else if(hdr.m_writtenRD == FPC::NativeRealDescriptor()) {
         infs->read((char *) fabdata, static_cast<std::streamsize>(fab.nBytes()));
       } else {
         Long readDataItems(fab.box().numPts() * fab.nComp());
@@ -2034,6 +2278,119 @@ VisMF::Read (FabArray<FArrayBox> &mf,
 }
 
 
+void
+VisMF::Read (FabArray<FArrayBox> &mf,
+             const std::string   &mf_name,
+             int scomp, int ncomp,
+             const BoxArray& region)
+{
+    BL_PROFILE("VisMF::Read(comps)");
+
+    VisMF vismf(mf_name);
+    Header& hdr = vismf.m_hdr;
+
+    AMREX_ALWAYS_ASSERT(scomp >= 0 && ncomp > 0 && scomp+ncomp <= hdr.m_ncomp);
+
+    if (mf.empty()) {
+        DistributionMapping dm = vismf_make_dm(hdr.m_ba);
+        mf.define(hdr.m_ba, dm, ncomp, hdr.m_ngrow, MFInfo(), FArrayBoxFactory());
+    } else {
+        BL_ASSERT(amrex::match(hdr.m_ba,mf.boxArray()));
+        AMREX_ALWAYS_ASSERT(mf.nComp() == ncomp && mf.nGrowVect() == hdr.m_ngrow);
+    }
+
+    const int myProc = ParallelDescriptor::MyProc();
+    const DistributionMapping& dm = mf.DistributionMap();
+
+    // ---- The parts of each FAB to read, and the ranks reading each file
+    std::map<int,BoxList> readBoxes;                          // ---- [fab index, boxes]
+    std::map<std::string, std::set<int> > readFileRanks;      // ---- [filename, ranks]
+    for (int i = 0, N = static_cast<int>(hdr.m_ba.size()); i < N; ++i) {
+        const Box fab_box = amrex::grow(hdr.m_ba[i], hdr.m_ngrow);
+        BoxList bl;
+        if (region.empty()) {
+            bl.push_back(fab_box);
+        } else {
+            for (auto const& is : region.intersections(fab_box)) {
+                bl.push_back(is.second);
+            }
+        }
+        if (bl.isNotEmpty()) {
+            readFileRanks[hdr.m_fod[i].m_name].insert(dm[i]);
+            if (dm[i] == myProc) { readBoxes[i] = std::move(bl); }
+        }
+    }
+
+    auto read_fab = [&] (int idx)
+    {
+        FArrayBox& fab = mf[idx];
+        FArrayBox* dst = &fab;
+#ifdef AMREX_USE_GPU
+        std::unique_ptr<FArrayBox> hostfab;
+        if (fab.arena()->isManaged() || fab.arena()->isDevice()) {
+            hostfab = std::make_unique<FArrayBox>(fab.box(), ncomp, The_Pinned_Arena());
+            dst = hostfab.get();
+        }
+#endif
+        for (auto const& b : readBoxes[idx]) {
+            vismf.readFABRegion(*dst, 0, b, idx, scomp, ncomp);
+        }
+#ifdef AMREX_USE_GPU
+        if (hostfab) {
+            for (auto const& b : readBoxes[idx]) {
+                fab.copy<RunOn::Device>(*hostfab, b, 0, b, 0, ncomp);
+            }
+            Gpu::streamSynchronize();
+        }
+#endif
+    };
+
+#ifdef BL_USE_MPI
+    // ---- This limits the number of concurrent readers per file.
+    const int nOpensPerFile(nMFFileInStreams);
+
+    for (auto const& [fileName, rfrSet] : readFileRanks) {
+        // ---- split the set into nstreams sets
+        int ssSize = static_cast<int>(rfrSet.size());
+        int nStreams(std::min(ssSize, nOpensPerFile));
+        int ranksPerStream(ssSize / nStreams); // ---- plus some remainder...
+        Vector<Vector<int> > streamRanks(nStreams);
+        int sIndex(0), sCount(0);
+        for (int r : rfrSet) {
+            streamRanks[sIndex].push_back(r);
+            if (++sCount >= ranksPerStream) {
+                sCount = 0;
+                sIndex = std::min(sIndex+1, nStreams-1);
+            }
+        }
+
+        for (auto& readRanks : streamRanks) {
+            if (std::find(readRanks.begin(), readRanks.end(), myProc) == readRanks.end()) {
+                continue;
+            }
+            std::string fullFileName(VisMF::DirName(mf_name) + fileName);
+            for (NFilesIter nfi(std::move(fullFileName), std::move(readRanks)); nfi.ReadyToRead(); ++nfi) {
+                for (auto const& rb : readBoxes) {
+                    if (hdr.m_fod[rb.first].m_name == fileName) {
+                        read_fab(rb.first);
+                    }
+                }
+            }
+        }
+    }
+#else
+    for (auto const& rb : readBoxes) {
+        read_fab(rb.first);
+    }
+#endif
+
+    if (VisMF::GetUsePersistentIFStreams()) {
+        for (auto const& fr : readFileRanks) {
+            VisMF::DeleteStream(VisMF::DirName(mf_name) + fr.first);
+        }
+    }
+}
+
 bool
 VisMF::Exist (const std::string& mf_name)
 {
@@ -2094,10 +2451,12 @@ VisMF::Check (const std::string& mf_name)
                        << "FullHdrFileName = " << FullHdrFileName << "\n";
     }
 
-    if(hdr.m_vers != VisMF::Header::Version_v1) {
+    if(hdr.m_vers != VisMF::Header::Version_v1 &&
+       hdr.m_vers != VisMF::Header::Compressed_v1)
+    {
      v1 = false;
      if (verbose) {
-         amrex::Print() << "**** VisMF::Check currently only supports Version_v1." << '\n';
+         amrex::Print() << "**** VisMF::Check currently only supports Version_v1 and Compressed_v1." << '\n';
      }
     } else {
 
@@ -2119,6 +2478,12 @@ VisMF::Check (const std::string& mf_name)
 
       ifs.seekg(fod.m_head, std::ios::beg);
 
+      if(hdr.m_vers == VisMF::Header::Compressed_v1) {
+        ifs >> c;
+        if(c != 'C') {
+          badFab = true;
+        }
+      }
       ifs >> c;
       if(c != 'F') {
         badFab = true;
@@ -2330,10 +2695,13 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
 
     bool strip_ghost = valid_cells_only && mf.nGrowVect() != 0;
 
+    // The FAB headers must match the raw native data written below.
+    FABio_binary fio_binary(FPC::NativeRealDescriptor().clone());
+    const FABio& fio = fio_binary;
+
     int64_t total_bytes = 0;
     if (localdata.size() > 1) {
         char* pld = (char*)(&(localdata[1]));
-        const FABio& fio = FArrayBox::getFABio();
         for (MFIter mfi(mf); mfi.isValid(); ++mfi)
         {
             std::memcpy(pld, &total_bytes, sizeof(int64_t));
@@ -2394,36 +2762,42 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
     }
 #endif
 
-    auto myfabs = std::make_shared<Vector<FArrayBox> >();
-    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
-        Box bx = strip_ghost ? mfi.validbox() : mfi.fabbox();
-#ifdef AMREX_USE_GPU
-        if (data_on_device) {
-            myfabs->emplace_back(bx, mf.nComp(), The_Pinned_Arena());
-            auto& new_fab = myfabs->back();
-            if (strip_ghost) {
-                new_fab.copy<RunOn::Device>(mf[mfi], bx);
-            } else {
-                Gpu::dtoh_memcpy_async(new_fab.dataPtr(), mf[mfi].dataPtr(), new_fab.size()*sizeof(Real));
-            }
-        } else
+    // Each rank writes its data at its own offset in the file it shares
+    // with its neighbors, so that the ranks do not have to take turns.
+    const auto my_info = AsyncOut::GetWriteInfo(myproc);
+    const std::string file_name = amrex::Concatenate(mf_name + FabFileSuffix, my_info.ifile, 5);
+
+    // Writes from an earlier AsyncWrite to the same file must land before
+    // the file is resized below. The AllGather makes sure that all the
+    // processes sharing the file have waited.
+    AsyncOut::WaitForWrites(file_name);
+
+    Vector<int64_t> nbytes_all(nprocs, total_bytes);
+#ifdef BL_USE_MPI
+    if (nprocs > 1) {
+        ParallelAllGather::AllGather(total_bytes, nbytes_all.data(),
+                                     ParallelDescriptor::Communicator());
+    }
 #endif
-        {
-            if (is_rvalue && ! strip_ghost) {
-                myfabs->emplace_back(std::move(const_cast<FArrayBox&>(mf[mfi])));
-            } else {
-                myfabs->emplace_back(bx, mf.nComp(), The_Cpu_Arena());
-                auto& new_fab = myfabs->back();
-                new_fab.copy<RunOn::Host>(mf[mfi], bx);
-            }
+    Long file_offset = 0;
+    for (int ip = myproc - my_info.ispot; ip < myproc; ++ip) {
+        file_offset += nbytes_all[ip];
+    }
+
+    // Instead of truncating the file, which could race with the writes of
+    // the other processes, it is resized. This only drops stale data past
+    // the end of the new file.
+    if (my_info.ispot == 0) {
+        Long file_size = 0;
+        for (int ip = myproc; ip < myproc + my_info.nspots; ++ip) {
+            file_size += nbytes_all[ip];
         }
+        AsyncOut::ResizeFile(file_name, file_size);
     }
 
-    std::shared_ptr<FABio> fabio(new FABio_binary(FPC::NativeRealDescriptor().clone()));
-
-    AsyncOut::Submit([=] ()
+    if (myproc == io_proc)
     {
-        if (myproc == io_proc)
+        AsyncOut::Submit([=] ()
         {
             hdr->m_fod.resize(n_global_fabs);
             hdr->m_min.resize(n_global_fabs);
@@ -2433,37 +2807,31 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
             hdr->m_famin.resize(ncomp,std::numeric_limits<Real>::max());
             hdr->m_famax.resize(ncomp,std::numeric_limits<Real>::lowest());
 
-            Vector<int64_t> nbytes_on_rank(nprocs,-1L);
             Vector<Vector<int> > gidx(nprocs);
             for (int k = 0; k < n_global_fabs; ++k) {
                 int rank = dm[k];
                 gidx[rank].push_back(k);
             }
 
+            // Every rank, including those without FABs, has sent its total
+            // number of bytes followed by the numbers of its FABs.
             auto* pgd = (char*)(globaldata->data());
+            for (int rank = 0; rank < nprocs; ++rank)
             {
-                int rank = 0, lidx = 0;
-                for (int j = 0; j < n_global_fabs; ++j)
-                {
-                    int k = -1;
-                    do {
-                        if (lidx < gidx[rank].size()) {
-                            k = gidx[rank][lidx];
-                            ++lidx;
-                        } else {
-                            ++rank;
-                            lidx = 0;
-                        }
-                    } while (k < 0);
+                pgd += sizeof(int64_t);
+
+                // The offset of the rank's data in its file
+                auto info = AsyncOut::GetWriteInfo(rank);
+                int64_t rank_offset = 0;
+                for (int ip = rank - info.ispot; ip < rank; ++ip) {
+                    rank_offset += nbytes_all[ip];
+                }
 
+                for (int k : gidx[rank])
+                {
                     hdr->m_min[k].resize(ncomp);
                     hdr->m_max[k].resize(ncomp);
 
-                    if (nbytes_on_rank[rank] < 0) { // First time for this rank
-                        std::memcpy(&(nbytes_on_rank[rank]), pgd, sizeof(int64_t));
-                        pgd += sizeof(int64_t);
-                    }
-
                     int64_t nbytes;
                     std::memcpy(&nbytes, pgd, sizeof(int64_t));
                     pgd += sizeof(int64_t);
@@ -2479,52 +2847,143 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
                         hdr->m_famax[icomp] = std::max(hdr->m_famax[icomp],cmax);
                     }
 
-                    auto info = AsyncOut::GetWriteInfo(rank);
                     hdr->m_fod[k].m_name = amrex::Concatenate(VisMF::BaseName(mf_name)+FabFileSuffix,
                                                               info.ifile, 5);
-                    hdr->m_fod[k].m_head = nbytes;
+                    hdr->m_fod[k].m_head = nbytes + rank_offset;
                 }
             }
 
-            Vector<int64_t> offset(nprocs);
-            for (int ip = 0; ip < nprocs; ++ip) {
-                auto info = AsyncOut::GetWriteInfo(ip);
-                if (info.ispot == 0) {
-                    offset[ip] = 0;
-                } else {
-                    offset[ip] = offset[ip-1] + nbytes_on_rank[ip-1];
-                }
-            }
+            VisMF::WriteHeaderDoit(mf_name, *hdr);
+        });
+    }
 
-            for (int k = 0; k < n_global_fabs; ++k) {
-                hdr->m_fod[k].m_head += offset[dm[k]];
+    // The data are copied into staging buffers, which are handed to the
+    // writer threads once full. The number of buffers is bounded, so that
+    // this blocks instead of duplicating the entire MultiFab.
+    BL_PROFILE_VAR("AsyncOut::Snapshot", blp_snapshot);
+
+    const std::size_t buffer_size = AsyncOut::StagingBufferSize();
+    char* buffer = nullptr;
+    std::size_t buffer_bytes = 0;
+
+    auto flush_buffer = [&] ()
+    {
+        if (buffer) {
+            if (buffer_bytes > 0) {
+                char* p = buffer;
+                AsyncOut::SubmitWrite(file_name, file_offset, p, buffer_bytes,
+                                      [p] () { AsyncOut::ReleaseStagingBuffer(p); });
+                file_offset += static_cast<Long>(buffer_bytes);
+            } else {
+                AsyncOut::ReleaseStagingBuffer(buffer);
             }
+            buffer = nullptr;
+            buffer_bytes = 0;
+        }
+    };
 
-            VisMF::WriteHeaderDoit(mf_name, *hdr);
+    // Returns the space left in the current buffer, getting a new one if needed.
+    auto buffer_space = [&] () -> std::size_t
+    {
+        if (buffer && buffer_bytes == buffer_size) { flush_buffer(); }
+        if (buffer == nullptr) {
+            BL_PROFILE_VAR_STOP(blp_snapshot);
+            buffer = AsyncOut::GetStagingBuffer();
+            BL_PROFILE_VAR_START(blp_snapshot);
         }
+        return buffer_size - buffer_bytes;
+    };
 
-        VisMF::IO_Buffer io_buffer(ioBufferSize);
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        const FArrayBox& fab = mf[mfi];
+        const Box bx = strip_ghost ? mfi.validbox() : mfi.fabbox();
 
-        AsyncOut::Wait();  // Wait for my turn
+        std::string fab_header;
+        {
+            std::stringstream hss;
+            FArrayBox header_fab(bx, ncomp, false);
+            fio.write_header(hss, header_fab, ncomp);
+            fab_header = hss.str();
+        }
+        for (std::size_t pos = 0; pos < fab_header.size(); ) {
+            std::size_t n = std::min(buffer_space(), fab_header.size()-pos);
+            std::memcpy(buffer+buffer_bytes, fab_header.data()+pos, n);
+            buffer_bytes += n;
+            pos += n;
+        }
 
-        auto info = AsyncOut::GetWriteInfo(myproc);
-        if (! myfabs->empty()) {
-            std::string file_name = amrex::Concatenate(mf_name + FabFileSuffix, info.ifile, 5);
-            std::ofstream ofs;
-            ofs.rdbuf()->pubsetbuf(io_buffer.dataPtr(), io_buffer.size());
-            ofs.open(file_name.c_str(), (info.ispot == 0) ? (std::ios::binary | std::ios::trunc)
-                                                          : (std::ios::binary | std::ios::app));
-            if (!ofs.good()) { amrex::FileOpenFailed(file_name); }
-            for (auto const& fab : *myfabs) {
-                fabio->write_header(ofs, fab, fab.nComp());
-                fabio->write(ofs, fab, 0, fab.nComp());
+        if (is_rvalue && !strip_ghost && !data_on_device) {
+            // The data are ours to keep until written.
+            flush_buffer();
+            auto owner = std::make_shared<FArrayBox>(std::move(const_cast<FArrayBox&>(fab)));
+            const auto nbytes = static_cast<std::size_t>(owner->size()*sizeof(Real));
+            AsyncOut::SubmitWrite(file_name, file_offset, (char const*)owner->dataPtr(),
+                                  nbytes, [owner] () {});
+            file_offset += static_cast<Long>(nbytes);
+            continue;
+        }
+
+#ifdef AMREX_USE_GPU
+        // The valid region is first made contiguous on the device.
+        FArrayBox valid_fab;
+        if (strip_ghost && data_on_device) {
+            valid_fab.resize(bx, ncomp, The_Async_Arena());
+            valid_fab.copy<RunOn::Device>(fab, bx, 0, bx, 0, ncomp);
+        }
+        Real const* data = (strip_ghost && data_on_device) ? valid_fab.dataPtr() : fab.dataPtr();
+#else
+        Real const* data = fab.dataPtr();
+#endif
+
+        if (!strip_ghost || data_on_device)
+        {
+            // The data are contiguous.
+            const Long nelems = bx.numPts() * ncomp;
+            for (Long ielem = 0; ielem < nelems; )
+            {
+                if (buffer_space() < sizeof(Real)) { flush_buffer(); }
+                const Long n = std::min(static_cast<Long>(buffer_space()/sizeof(Real)), nelems-ielem);
+                char* dst = buffer + buffer_bytes;
+                Real const* src = data + ielem;
+#ifdef AMREX_USE_GPU
+                if (data_on_device) {
+                    Gpu::dtoh_memcpy_async(dst, src, n*sizeof(Real));
+                    Gpu::streamSynchronize();
+                } else
+#endif
+                {
+                    std::memcpy(dst, src, n*sizeof(Real));
+                }
+                buffer_bytes += static_cast<std::size_t>(n*sizeof(Real));
+                ielem += n;
             }
-            ofs.flush();
-            ofs.close();
         }
+        else
+        {
+            // The valid region of a FAB on the host is copied row by row.
+            auto const& a = fab.const_array();
+            const auto lo = amrex::lbound(bx);
+            const auto hi = amrex::ubound(bx);
+            const Long len = hi.x - lo.x + 1;
+            for (int n = 0; n < ncomp; ++n) {
+            for (int k = lo.z; k <= hi.z; ++k) {
+            for (int j = lo.y; j <= hi.y; ++j) {
+                Real const* src = a.ptr(lo.x,j,k,n);
+                for (Long i = 0; i < len; )
+                {
+                    if (buffer_space() < sizeof(Real)) { flush_buffer(); }
+                    const Long m = std::min(static_cast<Long>(buffer_space()/sizeof(Real)), len-i);
+                    std::memcpy(buffer+buffer_bytes, src+i, m*sizeof(Real));
+                    buffer_bytes += static_cast<std::size_t>(m*sizeof(Real));
+                    i += m;
+                }
+            }}}
+        }
+    }
 
-        AsyncOut::Notify();  // Notify others I am done
-    });
+    flush_buffer();
+    AsyncOut::CloseFile(file_name);
 }
 
 }
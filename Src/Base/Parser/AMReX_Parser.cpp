@@ -7,6 +7,32 @@
 
 #include <algorithm>
 
+#ifdef AMREX_PARSER_NATIVE
+#include <AMReX_FileSystem.H>
+#include <AMReX_ParallelContext.H>
+#include <AMReX_ParmParse.H>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#ifdef __APPLE__
+#include <crt_externs.h>
+#else
+extern char** environ;
+#endif
+#endif
+
 namespace amrex {
 
 Parser::Parser (std::string const& func_body)
@@ -42,6 +68,9 @@ Parser::Data::~Data ()
 {
     m_expression.clear();
     if (m_parser) { amrex_parser_delete(m_parser); }
+#ifdef AMREX_PARSER_NATIVE
+    if (m_native_handle) { dlclose(m_native_handle); }
+#endif
     if (m_host_executor) {
         if (m_use_arena) {
             The_Pinned_Arena()->free(m_host_executor);
@@ -107,6 +136,16 @@ Parser::maxStackSize () const
     }
 }
 
+int
+Parser::instructionCount (bool optimized) const
+{
+    if (m_data && m_data->m_parser) {
+        return optimized ? m_data->m_exe_count : m_data->m_exe_count_unoptimized;
+    } else {
+        return 0;
+    }
+}
+
 std::string
 Parser::expr () const
 {
@@ -135,4 +174,304 @@ Parser::printExe () const
     }
 }
 
+#ifdef AMREX_PARSER_NATIVE
+
+namespace {
+
+// Functions used by the C++ code from parser_cpp. They must give the same
+// results as parser_call_f1, parser_call_f2 and the POWI instruction.
+constexpr char parser_native_preamble[] = R"(#include <cmath>
+#include <limits>
+
+namespace {
+inline double f_sqrt (double a) { return std::sqrt(a); }
+inline double f_exp (double a) { return std::exp(a); }
+inline double f_log (double a) { return std::log(a); }
+inline double f_log10 (double a) { return std::log10(a); }
+inline double f_sin (double a) { return std::sin(a); }
+inline double f_cos (double a) { return std::cos(a); }
+inline double f_tan (double a) { return std::tan(a); }
+inline double f_asin (double a) { return std::asin(a); }
+inline double f_acos (double a) { return std::acos(a); }
+inline double f_atan (double a) { return std::atan(a); }
+inline double f_sinh (double a) { return std::sinh(a); }
+inline double f_cosh (double a) { return std::cosh(a); }
+inline double f_tanh (double a) { return std::tanh(a); }
+inline double f_asinh (double a) { return std::asinh(a); }
+inline double f_acosh (double a) { return std::acosh(a); }
+inline double f_atanh (double a) { return std::atanh(a); }
+inline double f_abs (double a) { return std::abs(a); }
+inline double f_floor (double a) { return std::floor(a); }
+inline double f_ceil (double a) { return std::ceil(a); }
+inline double f_comp_ellint_1 (double a) { return std::comp_ellint_1(a); }
+inline double f_comp_ellint_2 (double a) { return std::comp_ellint_2(a); }
+inline double f_erf (double a) { return std::erf(a); }
+inline double f_pow (double a, double b) { return std::pow(a,b); }
+inline double f_atan2 (double a, double b) { return std::atan2(a,b); }
+inline double f_gt (double a, double b) { return (a > b) ? 1.0 : 0.0; }
+inline double f_lt (double a, double b) { return (a < b) ? 1.0 : 0.0; }
+inline double f_geq (double a, double b) { return (a >= b) ? 1.0 : 0.0; }
+inline double f_leq (double a, double b) { return (a <= b) ? 1.0 : 0.0; }
+inline double f_eq (double a, double b) { return (a == b) ? 1.0 : 0.0; }
+inline double f_neq (double a, double b) { return (a != b) ? 1.0 : 0.0; }
+inline double f_and (double a, double b) { return ((a != 0.0) && (b != 0.0)) ? 1.0 : 0.0; }
+inline double f_or (double a, double b) { return ((a != 0.0) || (b != 0.0)) ? 1.0 : 0.0; }
+inline double f_heaviside (double a, double b) { return (a < 0.0) ? 0.0 : ((a > 0.0) ? 1.0 : b); }
+inline double f_jn (double a, double b) { return ::jn(int(a),b); }
+inline double f_yn (double a, double b) { return ::yn(int(a),b); }
+inline double f_min (double a, double b) { return (a < b) ? a : b; }
+inline double f_max (double a, double b) { return (a > b) ? a : b; }
+inline double f_fmod (double a, double b) { return std::fmod(a,b); }
+inline double f_powi (double d, int n)
+{
+    if (n == 2) { return d*d; }
+    if (n == 3) { return d*(d*d); }
+    if (n == 4) { d *= d; return d*d; }
+    if (n == 0) { return 1.0; }
+    if (n < 0) { d = 1.0/d; n = -n; }
+    double y = 1.0;
+    while (n > 1) {
+        if (n % 2 != 0) { y *= d; }
+        d *= d;
+        n /= 2;
+    }
+    return d*y;
+}
+}
+
+)";
+
+std::uint64_t parser_native_hash (std::string const& s)
+{
+    std::uint64_t h = 14695981039346656037ULL; // FNV-1a
+    for (char c : s) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+// The default cache directory is private to the user.
+std::string parser_native_default_cache_dir ()
+{
+    char const* xdg = std::getenv("XDG_CACHE_HOME");
+    if (xdg && *xdg) {
+        return std::string(xdg) + "/amrex_parser_native";
+    }
+    char const* home = std::getenv("HOME");
+    if (home && *home) {
+        return std::string(home) + "/.cache/amrex_parser_native";
+    }
+    char const* tmpdir = std::getenv("TMPDIR");
+    return std::string((tmpdir && *tmpdir) ? tmpdir : "/tmp")
+        + "/amrex_parser_native_" + std::to_string(::geteuid());
+}
+
+// Libraries are only loaded from a directory that nobody else can write
+// to, i.e., one owned by the user with mode 0700.
+bool parser_native_check_dir (std::string const& dir, bool create)
+{
+    struct stat st{};
+    if (::stat(dir.c_str(), &st) != 0) {
+        if (!create || !FileSystem::CreateDirectories(dir, 0700) ||
+            ::stat(dir.c_str(), &st) != 0) {
+            return false;
+        }
+    }
+    return S_ISDIR(st.st_mode) && st.st_uid == ::geteuid()
+        && (st.st_mode & 0777) == 0700;
+}
+
+bool parser_native_check_file (std::string const& file)
+{
+    struct stat st{};
+    return ::lstat(file.c_str(), &st) == 0 && S_ISREG(st.st_mode)
+        && st.st_uid == ::geteuid() && (st.st_mode & 0022) == 0;
+}
+
+// Shared libraries cannot use environ directly on macOS.
+char** parser_native_environ ()
+{
+#ifdef __APPLE__
+    return *_NSGetEnviron();
+#else
+    return environ;
+#endif
+}
+
+// Run the compiler without a shell. The compiler and the flags are split
+// at whitespace, and the output goes to log.
+bool parser_native_run (std::string const& compiler, std::string const& flags,
+                        std::string const& obj, std::string const& src,
+                        std::string const& log)
+{
+    std::vector<std::string> args;
+    {
+        std::istringstream is(compiler + ' ' + flags);
+        std::string a;
+        while (is >> a) { args.push_back(a); }
+    }
+    if (args.empty()) { return false; }
+    args.emplace_back("-o");
+    args.push_back(obj);
+    args.push_back(src);
+
+    std::vector<char*> argv;
+    argv.reserve(args.size()+1);
+    for (auto& a : args) { argv.push_back(a.data()); }
+    argv.push_back(nullptr);
+
+    posix_spawn_file_actions_t actions;
+    if (posix_spawn_file_actions_init(&actions) != 0) { return false; }
+    bool ok = posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, log.c_str(),
+                                               O_WRONLY | O_CREAT | O_TRUNC, 0600) == 0
+        && posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO) == 0;
+    pid_t pid = 0;
+    ok = ok && posix_spawnp(&pid, argv[0], &actions, nullptr, argv.data(), parser_native_environ()) == 0;
+    posix_spawn_file_actions_destroy(&actions);
+    if (!ok) { return false; }
+
+    int status = 0;
+    while (::waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR) { return false; }
+    }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// Compile src into base.so, unless it exists. Returns an error message on
+// failure.
+std::string parser_native_build (std::string const& compiler, std::string const& flags,
+                                 std::string const& src, std::string const& base)
+{
+    const std::string lib = base + ".so";
+    if (FileSystem::Exists(lib)) { return std::string(); }
+
+    // Other nodes may be compiling the same code into a shared file system.
+    // So we compile into unique files and then rename the library, which is
+    // atomic.
+    const std::string tmp = base + "." + std::to_string(ParallelDescriptor::MyProc())
+        + "." + std::to_string(::getpid());
+    {
+        std::ofstream ofs(tmp + ".cpp");
+        ofs << src;
+        if (!ofs) {
+            return "failed to write " + tmp + ".cpp";
+        }
+    }
+    if (!parser_native_run(compiler, flags, tmp + ".so", tmp + ".cpp", tmp + ".log")) {
+        return "\"" + compiler + " " + flags + "\" failed (see " + tmp + ".log)";
+    }
+    std::rename((tmp + ".cpp").c_str(), (base + ".cpp").c_str());
+    std::rename((tmp + ".so").c_str(), lib.c_str());
+    std::remove((tmp + ".log").c_str());
+    return std::string();
+}
+
+}
+
+void
+Parser::compileNativeCode () const
+{
+    m_data->m_native_tried = true;
+
+    std::string compiler("c++");
+    std::string flags("-O2 -ffp-contract=off -fPIC -shared -std=c++17");
+    std::string cache_dir = parser_native_default_cache_dir();
+    {
+        ParmParse pp("amrex");
+        pp.query("parser_native_compiler", compiler);
+        pp.query("parser_native_flags", flags);
+        pp.query("parser_native_cache_dir", cache_dir);
+    }
+
+    const int nx = std::max(m_data->m_nvars, 1);
+    std::string src(parser_native_preamble);
+    src.append("extern \"C\" double amrex_parser_native (double const* x)\n{\n")
+        .append("    (void)x;\n")
+        .append(parser_cpp(m_data->m_parser))
+        .append("}\n\n")
+        .append("extern \"C\" void amrex_parser_native_batch (int n, double const* const* x,"
+                " double* r)\n{\n")
+        .append("    for (int m = 0; m < n; ++m) {\n")
+        .append("        double xm[" + std::to_string(nx) + "];\n")
+        .append("        for (int i = 0; i < " + std::to_string(m_data->m_nvars)
+                + "; ++i) { xm[i] = x[i][m]; }\n")
+        .append("        r[m] = amrex_parser_native(xm);\n")
+        .append("    }\n}\n");
+
+    // The library is keyed by the code and how it is compiled.
+    std::ostringstream key;
+    key << std::hex << std::setw(16) << std::setfill('0')
+        << parser_native_hash(src + '\n' + compiler + ' ' + flags);
+    const std::string base = cache_dir + "/amrex_parser_" + key.str();
+    const std::string lib = base + ".so";
+
+    auto fallback = [&] (std::string const& msg) {
+        if (amrex::Verbose()) {
+            amrex::Print() << "Parser::compileNative: " << msg << " for \""
+                           << m_data->m_expression << "\". The bytecode is used.\n";
+        }
+    };
+
+    // One process per node compiles, while the others wait.
+    int rank_in_node = 0;
+#ifdef AMREX_USE_MPI
+    MPI_Comm node_comm = MPI_COMM_NULL;
+    if (ParallelContext::NProcsSub() > 1) {
+        BL_MPI_REQUIRE( MPI_Comm_split_type(ParallelContext::CommunicatorSub(),
+                                            MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL,
+                                            &node_comm) );
+        BL_MPI_REQUIRE( MPI_Comm_rank(node_comm, &rank_in_node) );
+    }
+#endif
+
+    std::string error;
+    if (rank_in_node == 0) {
+        if (parser_native_check_dir(cache_dir, true)) {
+            error = parser_native_build(compiler, flags, src, base);
+        } else {
+            error = cache_dir + " is not a directory owned by the user with mode 0700";
+        }
+    }
+
+#ifdef AMREX_USE_MPI
+    if (node_comm != MPI_COMM_NULL) {
+        int failed = error.empty() ? 0 : 1;
+        BL_MPI_REQUIRE( MPI_Bcast(&failed, 1, MPI_INT, 0, node_comm) );
+        BL_MPI_REQUIRE( MPI_Comm_free(&node_comm) );
+        if (failed && error.empty()) {
+            error = "the compilation on another process failed";
+        }
+    }
+#endif
+
+    if (!error.empty()) {
+        fallback(error);
+        return;
+    }
+
+    if (!parser_native_check_dir(cache_dir, false) || !parser_native_check_file(lib)) {
+        fallback(lib + " is not a file owned by the user in a private directory");
+        return;
+    }
+
+    void* handle = dlopen(lib.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (handle == nullptr) {
+        fallback(std::string("dlopen failed: ") + dlerror());
+        return;
+    }
+    void* f = dlsym(handle, "amrex_parser_native");
+    void* fb = dlsym(handle, "amrex_parser_native_batch");
+    if (f == nullptr || fb == nullptr) {
+        dlclose(handle);
+        fallback("dlsym failed for " + lib);
+        return;
+    }
+    m_data->m_native_handle = handle;
+    m_data->m_native = reinterpret_cast<double(*)(double const*)>(f); // NOLINT
+    m_data->m_native_batch = reinterpret_cast<void(*)(int, double const* const*, double*)>(fb); // NOLINT
+}
+
+#endif
+
 }
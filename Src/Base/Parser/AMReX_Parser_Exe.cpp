@@ -1,4 +1,5 @@
 #include <AMReX_Parser_Exe.H>
+#include <AMReX_ParmParse.H>
 #include <utility>
 
 namespace amrex {
@@ -1064,4 +1065,82 @@ void parser_exe_print(char const* p, Vector<std::string> const& vars,
     }
 }
 
+
+int parser_exe_count (char const* p)
+{
+    int count = 0;
+    while (*((parser_exe_t*)p) != PARSER_EXE_NULL) { // NOLINT
+        switch (*((parser_exe_t*)p))
+        {
+        case PARSER_EXE_NUMBER: p += sizeof(ParserExeNumber); break;
+        case PARSER_EXE_SYMBOL: p += sizeof(ParserExeSymbol); break;
+        case PARSER_EXE_ADD: p += sizeof(ParserExeADD); break;
+        case PARSER_EXE_SUB_F: p += sizeof(ParserExeSUB_F); break;
+        case PARSER_EXE_SUB_B: p += sizeof(ParserExeSUB_B); break;
+        case PARSER_EXE_MUL: p += sizeof(ParserExeMUL); break;
+        case PARSER_EXE_DIV_F: p += sizeof(ParserExeDIV_F); break;
+        case PARSER_EXE_DIV_B: p += sizeof(ParserExeDIV_B); break;
+        case PARSER_EXE_F1: p += sizeof(ParserExeF1); break;
+        case PARSER_EXE_F2_F: p += sizeof(ParserExeF2_F); break;
+        case PARSER_EXE_F2_B: p += sizeof(ParserExeF2_B); break;
+        case PARSER_EXE_ADD_VP: p += sizeof(ParserExeADD_VP); break;
+        case PARSER_EXE_SUB_VP: p += sizeof(ParserExeSUB_VP); break;
+        case PARSER_EXE_MUL_VP: p += sizeof(ParserExeMUL_VP); break;
+        case PARSER_EXE_DIV_VP: p += sizeof(ParserExeDIV_VP); break;
+        case PARSER_EXE_ADD_PP: p += sizeof(ParserExeADD_PP); break;
+        case PARSER_EXE_SUB_PP: p += sizeof(ParserExeSUB_PP); break;
+        case PARSER_EXE_MUL_PP: p += sizeof(ParserExeMUL_PP); break;
+        case PARSER_EXE_DIV_PP: p += sizeof(ParserExeDIV_PP); break;
+        case PARSER_EXE_ADD_VN: p += sizeof(ParserExeADD_VN); break;
+        case PARSER_EXE_SUB_VN: p += sizeof(ParserExeSUB_VN); break;
+        case PARSER_EXE_MUL_VN: p += sizeof(ParserExeMUL_VN); break;
+        case PARSER_EXE_DIV_VN: p += sizeof(ParserExeDIV_VN); break;
+        case PARSER_EXE_ADD_PN: p += sizeof(ParserExeADD_PN); break;
+        case PARSER_EXE_SUB_PN: p += sizeof(ParserExeSUB_PN); break;
+        case PARSER_EXE_MUL_PN: p += sizeof(ParserExeMUL_PN); break;
+        case PARSER_EXE_DIV_PN: p += sizeof(ParserExeDIV_PN); break;
+        case PARSER_EXE_SQUARE: p += sizeof(ParserExeSquare); break;
+        case PARSER_EXE_POWI: p += sizeof(ParserExePOWI); break;
+        case PARSER_EXE_IF: p += sizeof(ParserExeIF); break;
+        case PARSER_EXE_JUMP: p += sizeof(ParserExeJUMP); break;
+        default:
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(false,"parser_exe_count: unknown node type");
+        }
+        ++count;
+    }
+    return count;
+}
+
+int parser_exe_count (struct amrex_parser* parser)
+{
+    int max_stack_size = 0;
+    int stack_size = 0;
+    Vector<char> exe(parser_exe_size(parser, max_stack_size, stack_size));
+    parser_compile(parser, exe.data());
+    return parser_exe_count(exe.data());
+}
+
+void parser_exe_optimize (struct amrex_parser* parser)
+{
+    bool cse = true;
+    {
+        ParmParse pp("amrex");
+        pp.query("parser_cse", cse);
+    }
+    if (!cse) { return; }
+
+    parser_ast_sort(parser->ast);
+    struct amrex_parser* opt = parser_optimize_exe(parser);
+    if (opt) {
+        // The locals take stack space. Keep the original if it is too much.
+        int max_stack_size = 0;
+        int stack_size = 0;
+        parser_exe_size(opt, max_stack_size, stack_size);
+        if (max_stack_size <= AMREX_PARSER_STACK_SIZE) {
+            std::swap(*parser, *opt);
+        }
+        amrex_parser_delete(opt);
+    }
+}
+
 }
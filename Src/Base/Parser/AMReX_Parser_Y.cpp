@@ -4,7 +4,10 @@
 
 #include <algorithm>
 #include <cstdarg>
+#include <limits>
+#include <sstream>
 #include <string>
+#include <vector>
 
 void
 amrex_parsererror (char const *s, ...)
@@ -1615,6 +1618,348 @@ void parser_ast_get_symbols (struct parser_node* node, std::set<std::string>& sy
     }
 }
 
+namespace {
+
+    // Pointers to the child slots of a node so that subtrees can be replaced
+    int parser_ast_children (struct parser_node* node, struct parser_node** c[3])
+    {
+        switch (node->type)
+        {
+        case PARSER_ADD:
+        case PARSER_SUB:
+        case PARSER_MUL:
+        case PARSER_DIV:
+        case PARSER_LIST:
+            c[0] = &(node->l);
+            c[1] = &(node->r);
+            return 2;
+        case PARSER_F1:
+            c[0] = &(((struct parser_f1*)node)->l);
+            return 1;
+        case PARSER_F2:
+            c[0] = &(((struct parser_f2*)node)->l);
+            c[1] = &(((struct parser_f2*)node)->r);
+            return 2;
+        case PARSER_F3:
+            c[0] = &(((struct parser_f3*)node)->n1);
+            c[1] = &(((struct parser_f3*)node)->n2);
+            c[2] = &(((struct parser_f3*)node)->n3);
+            return 3;
+        case PARSER_ASSIGN:
+            c[0] = &(((struct parser_assign*)node)->v);
+            return 1;
+        default:
+            return 0;
+        }
+    }
+
+    bool parser_is_leaf (struct parser_node* node)
+    {
+        return node->type == PARSER_NUMBER || node->type == PARSER_SYMBOL;
+    }
+
+    bool parser_has_statement (struct parser_node* node)
+    {
+        if (node->type == PARSER_ASSIGN || node->type == PARSER_LIST) { return true; }
+        struct parser_node** c[3];
+        int nc = parser_ast_children(node, c);
+        for (int i = 0; i < nc; ++i) {
+            if (parser_has_statement(*c[i])) { return true; }
+        }
+        return false;
+    }
+
+    // Is it worth storing the subtree in a local? Binary operations on two
+    // leaves (e.g., x*y, 3+x and x-y) compile into a single instruction,
+    // which is as cheap as reading the local.
+    bool parser_cse_worthy (struct parser_node* node)
+    {
+        switch (node->type)
+        {
+        case PARSER_ADD:
+        case PARSER_SUB:
+        case PARSER_MUL:
+        case PARSER_DIV:
+            return !(parser_is_leaf(node->l) &&
+                     (parser_is_leaf(node->r) ||
+                      (node->r->type == PARSER_MUL &&
+                       node->r->l->type == PARSER_NUMBER &&
+                       parser_is_leaf(node->r->r))));
+        case PARSER_F1:
+        case PARSER_F2:
+        case PARSER_F3:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // Subtrees that are always evaluated, in post order. The branches of if
+    // are skipped so that we do not hoist work out of them.
+    void parser_cse_candidates (struct parser_node* node, std::vector<struct parser_node*>& v)
+    {
+        if (node->type == PARSER_F3) {
+            parser_cse_candidates(((struct parser_f3*)node)->n1, v);
+        } else {
+            struct parser_node** c[3];
+            int nc = parser_ast_children(node, c);
+            for (int i = 0; i < nc; ++i) {
+                parser_cse_candidates(*c[i], v);
+            }
+        }
+        if (parser_cse_worthy(node)) { v.push_back(node); }
+    }
+
+    int parser_ast_count (struct parser_node* node, struct parser_node* target)
+    {
+        if (parser_node_equal(node, target)) { return 1; }
+        int r = 0;
+        struct parser_node** c[3];
+        int nc = parser_ast_children(node, c);
+        for (int i = 0; i < nc; ++i) {
+            r += parser_ast_count(*c[i], target);
+        }
+        return r;
+    }
+
+    void parser_ast_replace (struct parser_node** slot, struct parser_node* target,
+                             struct parser_node* replacement)
+    {
+        if (parser_node_equal(*slot, target)) {
+            *slot = replacement;
+        } else {
+            struct parser_node** c[3];
+            int nc = parser_ast_children(*slot, c);
+            for (int i = 0; i < nc; ++i) {
+                parser_ast_replace(c[i], target, replacement);
+            }
+        }
+    }
+
+    void parser_ast_statements (struct parser_node* node, std::vector<struct parser_node*>& v)
+    {
+        if (node->type == PARSER_LIST) {
+            parser_ast_statements(node->l, v);
+            parser_ast_statements(node->r, v);
+        } else {
+            v.push_back(node);
+        }
+    }
+}
+
+struct amrex_parser*
+parser_optimize_exe (struct amrex_parser* parser)
+{
+    // Split the program into statements. Assignments can only be top-level
+    // statements before the final expression.
+    std::vector<struct parser_node*> stmts;
+    parser_ast_statements(parser->ast, stmts);
+    for (int i = 0; i < int(stmts.size()); ++i) {
+        bool last = (i+1 == int(stmts.size()));
+        if ((stmts[i]->type == PARSER_ASSIGN) == last) { return nullptr; }
+        struct parser_node* v = last ? stmts[i] : ((struct parser_assign*)stmts[i])->v;
+        if (parser_has_statement(v)) { return nullptr; }
+    }
+
+    // Nodes allocated here. They are freed after the new tree is copied
+    // into the memory pool of the new parser.
+    std::vector<struct parser_node*> fresh;
+    auto new_node = [&] (struct parser_node* n) { fresh.push_back(n); return n; };
+
+    std::set<std::string> names;
+    parser_ast_get_symbols(parser->ast, names, names);
+    int ntemps = 0;
+    auto new_local = [&] () {
+        std::string name;
+        do {
+            name = "_cse" + std::to_string(ntemps++);
+        } while (names.count(name));
+        return (struct parser_symbol*) new_node((struct parser_node*)
+                                                parser_makesymbol(name.data()));
+    };
+
+    // We modify a copy so that the original tree is still valid.
+    struct amrex_parser* work = parser_dup(parser);
+    stmts.clear();
+    parser_ast_statements(work->ast, stmts);
+
+    bool changed = false;
+    std::vector<struct parser_node*> new_stmts;
+    for (auto* stmt : stmts) {
+        // The expression is held in a slot so that it can be replaced too.
+        struct parser_node** expr = (stmt->type == PARSER_ASSIGN)
+            ? &(((struct parser_assign*)stmt)->v) : &stmt;
+        std::vector<struct parser_assign*> temps;
+
+        // Common subexpressions, smallest first
+        bool found = true;
+        while (found) {
+            found = false;
+            std::vector<struct parser_node*> cands;
+            parser_cse_candidates(*expr, cands);
+            for (auto* c : cands) {
+                if (parser_ast_count(*expr, c) > 1) {
+                    auto* sym = new_local();
+                    temps.push_back((struct parser_assign*)new_node(parser_newassign(sym, c)));
+                    parser_ast_replace(expr, c, (struct parser_node*)sym);
+                    found = true;
+                    break;
+                }
+            }
+        }
+
+        // Locals used only once are put back.
+        for (int i = int(temps.size())-1; i >= 0; --i) {
+            auto* sym = (struct parser_node*)(temps[i]->s);
+            int nuses = parser_ast_count(*expr, sym);
+            for (int j = i+1; j < int(temps.size()); ++j) {
+                nuses += parser_ast_count(temps[j]->v, sym);
+            }
+            if (nuses < 2) {
+                parser_ast_replace(expr, sym, temps[i]->v);
+                for (int j = i+1; j < int(temps.size()); ++j) {
+                    parser_ast_replace(&(temps[j]->v), sym, temps[i]->v);
+                }
+                temps.erase(temps.begin()+i);
+            }
+        }
+
+        changed = changed || !temps.empty();
+        for (auto* t : temps) { new_stmts.push_back((struct parser_node*)t); }
+        new_stmts.push_back(stmt);
+    }
+
+    struct amrex_parser* result = nullptr;
+    if (changed) {
+        struct parser_node* ast = new_stmts.back();
+        for (int i = int(new_stmts.size())-2; i >= 0; --i) {
+            ast = new_node(parser_newlist(new_stmts[i], ast));
+        }
+        result = (struct amrex_parser*) std::malloc(sizeof(struct amrex_parser));
+        result->sz_mempool = parser_ast_size(ast);
+        result->p_root = std::malloc(result->sz_mempool);
+        result->p_free = result->p_root;
+        result->ast = parser_ast_dup(result, ast, 0);
+    }
+
+    for (auto* n : fresh) {
+        if (n->type == PARSER_SYMBOL) {
+            std::free(((struct parser_symbol*)n)->name);
+        }
+        std::free(n);
+    }
+    amrex_parser_delete(work);
+
+    return result;
+}
+
+namespace {
+
+    void parser_ast_cpp (struct parser_node* node, std::ostream& os,
+                         std::vector<std::string> const& locals)
+    {
+        switch (node->type)
+        {
+        case PARSER_NUMBER:
+        {
+            double v = parser_get_number(node);
+            if (std::isnan(v)) {
+                os << "std::numeric_limits<double>::quiet_NaN()";
+            } else if (std::isinf(v)) {
+                os << ((v > 0.) ? "" : "-") << "std::numeric_limits<double>::infinity()";
+            } else {
+                os << "(" << std::hexfloat << v << std::defaultfloat << ")";
+            }
+            break;
+        }
+        case PARSER_SYMBOL:
+        {
+            auto* sym = (struct parser_symbol*)node;
+            auto r = std::find(locals.rbegin(), locals.rend(), std::string(sym->name));
+            if (r != locals.rend()) {
+                os << "l" << std::distance(r, locals.rend()) - 1;
+            } else if (sym->ip >= 0) {
+                os << "x[" << sym->ip << "]";
+            } else {
+                throw std::runtime_error(std::string("Unknown variable ") + sym->name);
+            }
+            break;
+        }
+        case PARSER_ADD:
+        case PARSER_SUB:
+        case PARSER_MUL:
+        case PARSER_DIV:
+        {
+            constexpr char ops[] = "  +-*/";
+            os << "(";
+            parser_ast_cpp(node->l, os, locals);
+            os << ops[node->type];
+            parser_ast_cpp(node->r, os, locals);
+            os << ")";
+            break;
+        }
+        case PARSER_F1:
+            os << "f_" << parser_f1_s[((struct parser_f1*)node)->ftype] << "(";
+            parser_ast_cpp(((struct parser_f1*)node)->l, os, locals);
+            os << ")";
+            break;
+        case PARSER_F2:
+        {
+            auto* f2 = (struct parser_f2*)node;
+            if (f2->ftype == PARSER_POW && f2->r->type == PARSER_NUMBER &&
+                parser_get_number(f2->r) == std::floor(parser_get_number(f2->r)) &&
+                std::abs(parser_get_number(f2->r)) < double(std::numeric_limits<int>::max()))
+            { // The same as SQUARE and POWI of the bytecode
+                os << "f_powi(";
+                parser_ast_cpp(f2->l, os, locals);
+                os << "," << int(parser_get_number(f2->r)) << ")";
+            } else {
+                os << "f_" << parser_f2_s[f2->ftype] << "(";
+                parser_ast_cpp(f2->l, os, locals);
+                os << ",";
+                parser_ast_cpp(f2->r, os, locals);
+                os << ")";
+            }
+            break;
+        }
+        case PARSER_F3:
+            os << "((";
+            parser_ast_cpp(((struct parser_f3*)node)->n1, os, locals);
+            os << ")!=0.0?";
+            parser_ast_cpp(((struct parser_f3*)node)->n2, os, locals);
+            os << ":";
+            parser_ast_cpp(((struct parser_f3*)node)->n3, os, locals);
+            os << ")";
+            break;
+        default:
+            amrex::Abort("parser_ast_cpp: unexpected node type " + std::to_string(node->type));
+        }
+    }
+}
+
+std::string
+parser_cpp (struct amrex_parser* parser)
+{
+    std::vector<struct parser_node*> stmts;
+    parser_ast_statements(parser->ast, stmts);
+    std::vector<std::string> locals;
+    std::ostringstream os;
+    for (auto* stmt : stmts) {
+        if (stmt->type == PARSER_ASSIGN) {
+            auto* asgn = (struct parser_assign*)stmt;
+            os << "    double const l" << locals.size() << " = ";
+            parser_ast_cpp(asgn->v, os, locals);
+            os << ";\n";
+            locals.emplace_back(asgn->s->name);
+        } else {
+            os << "    return ";
+            parser_ast_cpp(stmt, os, locals);
+            os << ";\n";
+        }
+    }
+    return os.str();
+}
+
 void
 parser_regvar (struct amrex_parser* parser, char const* name, int i)
 {
@@ -13,8 +13,15 @@
 #include <AMReX_EB2_IndexSpace_STL.H>
 #include <AMReX_EB2_IndexSpace_chkpt_file.H>
 #include <AMReX_ParmParse.H>
+#include <AMReX_FileSystem.H>
+#include <AMReX_Utility.H>
 #include <AMReX.H>
 #include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
 
 namespace amrex::EB2 {
 
@@ -80,10 +87,105 @@ const IndexSpace* TopIndexSpaceIfPresent() noexcept {
     return nullptr;
 }
 
+namespace {
+
+// 64-bit FNV-1a
+std::uint64_t hash_bytes (char const* p, std::size_t n,
+                          std::uint64_t h = 14695981039346656037ULL)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        h ^= static_cast<unsigned char>(p[i]);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+std::string cache_dir ()
+{
+    std::string dir;
+    ParmParse pp("eb2");
+    pp.query("cache_dir", dir);
+    return dir;
+}
+
+std::string
+cache_entry (std::string const& dir, std::string const& geometry_key,
+             const Geometry& geom, int required_coarsening_level,
+             int max_coarsening_level, int ngrow, bool extend_domain_face,
+             int num_coarsen_opt)
+{
+    std::ostringstream os;
+    os << std::setprecision(17)
+       << geometry_key << '\n'
+       << AMREX_SPACEDIM << ' ' << sizeof(Real) << '\n'
+       << geom.Domain() << '\n';
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        os << geom.ProbLo(idim) << ' ' << geom.ProbHi(idim) << ' '
+           << geom.isPeriodic(idim) << '\n';
+    }
+    os << required_coarsening_level << ' ' << max_coarsening_level << ' '
+       << ngrow << ' ' << extend_domain_face << ' ' << num_coarsen_opt << ' '
+       << EB2::max_grid_size << '\n';
+    std::string const& s = os.str();
+
+    std::ostringstream name;
+    name << dir << "/eb2_" << std::hex << std::setw(16) << std::setfill('0')
+         << hash_bytes(s.data(), s.size());
+    return name.str();
+}
+
+// Geometry key of the geometry given by eb2.geom_type and the other eb2
+// parameters. It is empty if the cache is not used. A chkpt geometry is
+// already read from a file, so it is not cached.
+std::string parmparse_geometry_key ()
+{
+    std::string geom_type;
+    ParmParse pp("eb2");
+    pp.query("geom_type", geom_type);
+    if (cache_dir().empty() || geom_type == "all_regular" || geom_type == "chkpt") {
+        return std::string();
+    }
+
+    ParmParse ppall;
+    std::ostringstream os;
+    for (auto const& name : ParmParse::getEntries("eb2")) {
+        if (name == "eb2.cache_dir") { continue; }
+        std::vector<std::string> v;
+        ppall.queryarr(name.c_str(), v);
+        os << name;
+        for (auto const& x : v) { os << ' ' << x; }
+        os << '\n';
+    }
+
+    if (geom_type == "stl") {
+        // The key includes the content of the file so that the entry is not
+        // used after the file is changed.
+        std::uint64_t h = 0;
+        if (ParallelDescriptor::IOProcessor()) {
+            std::string stl_file;
+            pp.get("stl_file", stl_file);
+            std::ifstream ifs(stl_file, std::ios::binary);
+            if (!ifs.good()) {
+                amrex::FileOpenFailed(stl_file);
+            }
+            h = 14695981039346656037ULL;
+            Vector<char> buf(1 << 20);
+            while (ifs) {
+                ifs.read(buf.data(), std::streamsize(buf.size()));
+                h = hash_bytes(buf.data(), std::size_t(ifs.gcount()), h);
+            }
+        }
+        ParallelDescriptor::Bcast(&h, 1, ParallelDescriptor::IOProcessorNumber());
+        os << "stl_file_hash " << h << '\n';
+    }
+
+    return os.str();
+}
+
 void
-Build (const Geometry& geom, int required_coarsening_level,
-       int max_coarsening_level, int ngrow, bool build_coarse_level_by_coarsening,
-       bool a_extend_domain_face, int a_num_coarsen_opt)
+build_from_parmparse (const Geometry& geom, int required_coarsening_level,
+                      int max_coarsening_level, int ngrow, bool build_coarse_level_by_coarsening,
+                      bool a_extend_domain_face, int a_num_coarsen_opt)
 {
     ParmParse pp("eb2");
     std::string geom_type;
@@ -234,6 +336,103 @@ Build (const Geometry& geom, int required_coarsening_level,
     }
 }
 
+}
+
+void
+Build (const Geometry& geom, int required_coarsening_level,
+       int max_coarsening_level, int ngrow, bool build_coarse_level_by_coarsening,
+       bool a_extend_domain_face, int a_num_coarsen_opt)
+{
+    std::string const& geometry_key = parmparse_geometry_key();
+    if (!BuildFromCache(geometry_key, geom, required_coarsening_level,
+                        max_coarsening_level, ngrow, build_coarse_level_by_coarsening,
+                        a_extend_domain_face, a_num_coarsen_opt))
+    {
+        build_from_parmparse(geom, required_coarsening_level, max_coarsening_level,
+                             ngrow, build_coarse_level_by_coarsening,
+                             a_extend_domain_face, a_num_coarsen_opt);
+        WriteToCache(geometry_key, geom, required_coarsening_level,
+                     max_coarsening_level, ngrow, build_coarse_level_by_coarsening,
+                     a_extend_domain_face, a_num_coarsen_opt);
+    }
+}
+
+bool
+BuildFromCache (std::string const& geometry_key, const Geometry& geom,
+                int required_coarsening_level, int max_coarsening_level,
+                int ngrow, bool build_coarse_level_by_coarsening,
+                bool a_extend_domain_face, int a_num_coarsen_opt)
+{
+    // Coarse levels can only be built by coarsening the cached level.
+    if (geometry_key.empty() || !build_coarse_level_by_coarsening) { return false; }
+    std::string const& dir = cache_dir();
+    if (dir.empty()) { return false; }
+
+    std::string const& entry = cache_entry(dir, geometry_key, geom,
+                                           required_coarsening_level,
+                                           max_coarsening_level, ngrow,
+                                           a_extend_domain_face, a_num_coarsen_opt);
+    int found = 0;
+    if (ParallelDescriptor::IOProcessor()) {
+        found = FileSystem::Exists(entry+"/Header");
+    }
+    ParallelDescriptor::Bcast(&found, 1, ParallelDescriptor::IOProcessorNumber());
+    if (!found) { return false; }
+
+    if (amrex::Verbose() > 0) {
+        amrex::Print() << "EB2: reading " << entry << " from EB cache\n";
+    }
+    BuildFromChkptFile(entry, geom, required_coarsening_level, max_coarsening_level,
+                       ngrow, build_coarse_level_by_coarsening, a_extend_domain_face);
+    return true;
+}
+
+void
+WriteToCache (std::string const& geometry_key, const Geometry& geom,
+              int required_coarsening_level, int max_coarsening_level,
+              int ngrow, bool build_coarse_level_by_coarsening,
+              bool a_extend_domain_face, int a_num_coarsen_opt)
+{
+    if (geometry_key.empty() || !build_coarse_level_by_coarsening) { return; }
+    std::string const& dir = cache_dir();
+    if (dir.empty()) { return; }
+
+    const Level& level = IndexSpace::top().getLevel(geom);
+    if (level.isAllRegular() || !level.hasEBInfo()) { return; }
+
+    std::string const& entry = cache_entry(dir, geometry_key, geom,
+                                           required_coarsening_level,
+                                           max_coarsening_level, ngrow,
+                                           a_extend_domain_face, a_num_coarsen_opt);
+
+    // Write to a temporary directory first and rename it. Thus an entry is
+    // either complete or absent even if several runs write it concurrently.
+    std::string tmp;
+    if (ParallelDescriptor::IOProcessor()) {
+        tmp = entry + ".tmp." + amrex::UniqueString();
+    }
+    {
+        Vector<char> buf(tmp.begin(), tmp.end());
+        int n = int(buf.size());
+        ParallelDescriptor::Bcast(&n, 1, ParallelDescriptor::IOProcessorNumber());
+        buf.resize(n);
+        ParallelDescriptor::Bcast(buf.data(), n, ParallelDescriptor::IOProcessorNumber());
+        tmp.assign(buf.begin(), buf.end());
+    }
+
+    level.write_to_chkpt_file(tmp, a_extend_domain_face, EB2::max_grid_size);
+    ParallelDescriptor::Barrier();
+
+    if (ParallelDescriptor::IOProcessor()) {
+        if (std::rename(tmp.c_str(), entry.c_str()) != 0) {
+            // Another run has written the entry.
+            FileSystem::RemoveAll(tmp);
+        } else if (amrex::Verbose() > 0) {
+            amrex::Print() << "EB2: wrote " << entry << " to EB cache\n";
+        }
+    }
+}
+
 void addFineLevels (int num_new_fine_levels)
 {
     BL_PROFILE("EB2::addFineLevels()");
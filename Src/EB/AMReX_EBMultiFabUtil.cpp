@@ -7,6 +7,7 @@
 #include <AMReX_EBMultiFabUtil_C.H>
 #include <AMReX_EBCellFlag.H>
 #include <AMReX_MultiCutFab.H>
+#include <AMReX_MultiCutCellList.H>
 
 #include <AMReX_VisMF.H>
 
@@ -907,6 +908,64 @@ EB_interp_CC_to_Centroid (MultiFab& cent, const MultiFab& cc, int scomp, int dco
 
 }
 
+void
+EB_interp_CC_to_Centroid (MultiFab& cent, const MultiFab& cc, int scomp, int dcomp, int ncomp, const Geometry& geom,
+                          const MultiCutCellList& cutcells)
+{
+    const auto& factory = dynamic_cast<EBFArrayBoxFactory const&>(cc.Factory());
+    const auto& flags = factory.getMultiEBCellFlagFab();
+    AMREX_ALWAYS_ASSERT(cutcells.local_size() == flags.local_size());
+
+    MFItInfo mfi_info;
+    if (Gpu::notInLaunchRegion()) { mfi_info.SetDynamic(true); }
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(cc, mfi_info);  mfi.isValid(); ++mfi)
+    {
+        const Box& vbx = mfi.validbox();
+        const auto& centfab = cent.array(mfi,dcomp);
+        const auto& fabtyp = flags[mfi].getType(vbx);
+
+        if (fabtyp == FabType::covered)
+        {
+            AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( vbx, ncomp, i, j, k, n,
+            {
+                centfab(i,j,k,n) = 0.0;
+            });
+        }
+        else
+        {
+            const auto& ccfab = cc.const_array(mfi,scomp);
+            AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( vbx, ncomp, i, j, k, n,
+            {
+               centfab(i,j,k,n) = ccfab(i,j,k,n);
+            });
+
+            if (fabtyp != FabType::regular)
+            {
+                // Only the cut cells need the interpolation.
+                auto const& cl = cutcells.const_list(mfi);
+                ParallelFor(cl.size(), [=] AMREX_GPU_DEVICE (int m) noexcept
+                {
+                    IntVect const& iv = cl.cell(m);
+                    if (vbx.contains(iv)) {
+                        auto const c = iv.dim3();
+                        for (int n = 0; n < ncomp; ++n) {
+                            eb_interp_cc2cent_cell(c.x, c.y, c.z, n, centfab, ccfab,
+                                                   AMREX_D_DECL(cl.get<EBData_t::centroid>(m,0),
+                                                                cl.get<EBData_t::centroid>(m,1),
+                                                                cl.get<EBData_t::centroid>(m,2)));
+                        }
+                    }
+                });
+            }
+        }
+    }
+
+    cent.FillBoundary(dcomp,ncomp,geom.periodicity());
+}
+
 void
 EB_interp_CC_to_FaceCentroid (const MultiFab& cc,
                               AMREX_D_DECL( MultiFab& fc_x,
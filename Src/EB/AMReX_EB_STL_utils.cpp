@@ -2,10 +2,11 @@
 #include <AMReX_EB_STL_utils.H>
 #include <AMReX_EB_triGeomOps_K.H>
 #include <AMReX_IntConv.H>
-#include <AMReX_Math.H>
+#include <AMReX_OpenMP.H>
 #include <AMReX_Stack.H>
 
 #include <cstring>
+#include <memory>
 
 // Reference for BVH: https://rmrsk.github.io/EBGeometry/Concepts.html#bounding-volume-hierarchies
 
@@ -189,15 +190,412 @@ namespace {
             }
         }
     }
+
+    // Communicators of the processes on this node and of the first process
+    // on each node.
+    struct STLNodeComm
+    {
+        MPI_Comm node = MPI_COMM_NULL;
+        MPI_Comm leaders = MPI_COMM_NULL;
+        int rank_in_node = 0;
+        int nprocs_in_node = 1;
+        int inode = 0;
+        int nnodes = 1;
+
+        STLNodeComm ()
+        {
+#ifdef AMREX_USE_MPI
+            if (ParallelContext::NProcsSub() > 1) {
+                MPI_Comm comm = ParallelContext::CommunicatorSub();
+                int myproc = ParallelContext::MyProcSub();
+                BL_MPI_REQUIRE(MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, myproc,
+                                                   MPI_INFO_NULL, &node));
+                MPI_Comm_rank(node, &rank_in_node);
+                MPI_Comm_size(node, &nprocs_in_node);
+                BL_MPI_REQUIRE(MPI_Comm_split(comm, (rank_in_node == 0) ? 0 : MPI_UNDEFINED,
+                                              myproc, &leaders));
+                int tmp[2] = {0, 0};
+                if (leaders != MPI_COMM_NULL) {
+                    MPI_Comm_rank(leaders, tmp);
+                    MPI_Comm_size(leaders, tmp+1);
+                }
+                MPI_Bcast(tmp, 2, MPI_INT, 0, node);
+                inode = tmp[0];
+                nnodes = tmp[1];
+            }
+#endif
+        }
+
+        ~STLNodeComm ()
+        {
+#ifdef AMREX_USE_MPI
+            if (leaders != MPI_COMM_NULL) { MPI_Comm_free(&leaders); }
+            if (node != MPI_COMM_NULL) { MPI_Comm_free(&node); }
+#endif
+        }
+
+        STLNodeComm (STLNodeComm const&) = delete;
+        STLNodeComm (STLNodeComm &&) = delete;
+        STLNodeComm& operator= (STLNodeComm const&) = delete;
+        STLNodeComm& operator= (STLNodeComm &&) = delete;
+    };
+
+    // Host memory shared by the processes on a node. Each process
+    // contributes a segment, and the segments are contiguous in the order
+    // of the ranks in the node. The constructor and the destructor are
+    // collective over the node. A passive target epoch is open for the
+    // lifetime of the window, so that sync can use MPI_Win_sync as the
+    // MPI-3 shared memory model requires.
+    class STLSharedMemory
+    {
+    public:
+        STLSharedMemory (std::size_t nbytes, STLNodeComm const& nc)
+        {
+#ifdef AMREX_USE_MPI
+            if (nc.node != MPI_COMM_NULL) {
+                BL_MPI_REQUIRE(MPI_Win_allocate_shared(MPI_Aint(nbytes), 1, MPI_INFO_NULL,
+                                                       nc.node, &m_mine, &m_win));
+                MPI_Aint sz;
+                int disp_unit;
+                BL_MPI_REQUIRE(MPI_Win_shared_query(m_win, MPI_PROC_NULL, &sz, &disp_unit,
+                                                    &m_base));
+                BL_MPI_REQUIRE(MPI_Win_lock_all(MPI_MODE_NOCHECK, m_win));
+                return;
+            }
+#else
+            amrex::ignore_unused(nc);
+#endif
+            m_buffer = std::make_unique<char[]>(nbytes);
+            m_base = m_mine = m_buffer.get();
+        }
+
+        ~STLSharedMemory ()
+        {
+#ifdef AMREX_USE_MPI
+            if (m_win != MPI_WIN_NULL) {
+                // Nothing can be freed after MPI_Finalize (e.g., for a
+                // static STLtools).
+                int finalized = 0;
+                MPI_Finalized(&finalized);
+                if (!finalized) {
+                    MPI_Win_unlock_all(m_win);
+                    MPI_Win_free(&m_win);
+                }
+            }
+#endif
+        }
+
+        STLSharedMemory (STLSharedMemory const&) = delete;
+        STLSharedMemory (STLSharedMemory &&) = delete;
+        STLSharedMemory& operator= (STLSharedMemory const&) = delete;
+        STLSharedMemory& operator= (STLSharedMemory &&) = delete;
+
+        //! Make the stores of every process on the node visible to the
+        //! others. This is collective over the node.
+        void sync (STLNodeComm const& nc) const
+        {
+#ifdef AMREX_USE_MPI
+            if (m_win != MPI_WIN_NULL) {
+                BL_MPI_REQUIRE(MPI_Win_sync(m_win));
+                BL_MPI_REQUIRE(MPI_Barrier(nc.node));
+                BL_MPI_REQUIRE(MPI_Win_sync(m_win));
+            }
+#else
+            amrex::ignore_unused(nc);
+#endif
+        }
+
+        //! Beginning of the memory of the whole node
+        template <typename T>
+        [[nodiscard]] T* base () const { return reinterpret_cast<T*>(m_base); }
+
+        //! Beginning of the segment of this process
+        template <typename T>
+        [[nodiscard]] T* mine () const { return reinterpret_cast<T*>(m_mine); }
+
+    private:
+        char* m_base = nullptr;
+        char* m_mine = nullptr;
+        std::unique_ptr<char[]> m_buffer;
+#ifdef AMREX_USE_MPI
+        MPI_Win m_win = MPI_WIN_NULL;
+#endif
+    };
+
+    using Triangle = STLtools::Triangle;
+    using Node = STLtools::Node;
+
+    // Maximum number of triangles in a subtree whose root is at the given
+    // depth, so that the tree can be traversed with the stack.
+    Long bvh_capacity (int depth)
+    {
+        Long r = STLtools::m_bvh_max_size;
+        for (int i = depth+1; i < STLtools::m_bvh_max_stack_size; ++i) {
+            r *= STLtools::m_bvh_max_splits;
+        }
+        return r;
+    }
+
+    void bvh_make_leaf (Triangle const* begin, int ntri, Node& node)
+    {
+        auto& bbox = node.boundingbox;
+        for (int tr = 0; tr < ntri; ++tr) {
+            auto const& tri = begin[tr];
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                auto const& [xmin,xmax] = tri.minmax(idim);
+                bbox.setLo(idim,amrex::min(xmin, bbox.lo(idim)));
+                bbox.setHi(idim,amrex::max(xmax, bbox.hi(idim)));
+            }
+            node.triangles[tr] = tri;
+            node.trinorm[tr] = triangle_norm(tri);
+        }
+#ifdef AMREX_USE_FLOAT
+        constexpr Real eps = Real(1.e-5);
+#else
+        constexpr Real eps = Real(1.e-10);
+#endif
+        Real sml = eps*std::max({AMREX_D_DECL(bbox.length(0),
+                                              bbox.length(1),
+                                              bbox.length(2))});
+        // Make bounding box slightly bigger for robustness.
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bbox.setLo(idim,bbox.lo(idim)-sml);
+            bbox.setHi(idim,bbox.hi(idim)+sml);
+        }
+        node.ntriangles = std::int8_t(ntri);
+    }
+
+    void bvh_update_bbox (Node& node, Node const* bvh_nodes)
+    {
+        for (int ichild = 0; ichild < node.nchildren; ++ichild) {
+            int inode = node.children[ichild];
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                auto lo = node.boundingbox.lo(idim);
+                auto hi = node.boundingbox.hi(idim);
+                auto clo = bvh_nodes[inode].boundingbox.lo(idim);
+                auto chi = bvh_nodes[inode].boundingbox.hi(idim);
+                node.boundingbox.setLo(idim, std::min(lo,clo));
+                node.boundingbox.setHi(idim, std::max(hi,chi));
+            }
+        }
+    }
+
+    // Split [begin,end) into two non-empty ranges using the surface area
+    // heuristic. The centroids are binned in each direction, and the split
+    // minimizing n_left*area_left + n_right*area_right is chosen, where n
+    // is the number of leaves needed for the triangles. It returns the
+    // beginning of the right range.
+    Triangle* bvh_sah_split (Triangle* begin, Triangle* end)
+    {
+        constexpr int nbins = 16;
+        constexpr Real rmax = std::numeric_limits<Real>::max();
+        constexpr Real rlowest = std::numeric_limits<Real>::lowest();
+
+        Real cmin[3] = {rmax, rmax, rmax};
+        Real cmax[3] = {rlowest, rlowest, rlowest};
+        for (auto const* p = begin; p != end; ++p) {
+            for (int d = 0; d < 3; ++d) {
+                Real c = p->cent(d);
+                cmin[d] = std::min(cmin[d], c);
+                cmax[d] = std::max(cmax[d], c);
+            }
+        }
+
+        Real scale[3];
+        for (int d = 0; d < 3; ++d) {
+            scale[d] = (cmax[d] > cmin[d]) ? Real(nbins)/(cmax[d]-cmin[d]) : Real(0.);
+        }
+        auto get_bin = [&] (Real c, int d) -> int
+        {
+            return std::min(int((c-cmin[d])*scale[d]), nbins-1);
+        };
+
+        struct Bin {
+            Long count = 0;
+            Real lo[3] = {rmax, rmax, rmax};
+            Real hi[3] = {rlowest, rlowest, rlowest};
+            void add (Real const* a_lo, Real const* a_hi) {
+                for (int d = 0; d < 3; ++d) {
+                    lo[d] = std::min(lo[d], a_lo[d]);
+                    hi[d] = std::max(hi[d], a_hi[d]);
+                }
+            }
+            [[nodiscard]] Real area () const {
+                Real lx = hi[0]-lo[0], ly = hi[1]-lo[1], lz = hi[2]-lo[2];
+                return lx*ly + ly*lz + lz*lx;
+            }
+        };
+
+        Bin bins[3][nbins];
+        for (auto const* p = begin; p != end; ++p) {
+            Real tlo[3], thi[3];
+            for (int d = 0; d < 3; ++d) {
+                auto const& [xmin,xmax] = p->minmax(d);
+                tlo[d] = xmin;
+                thi[d] = xmax;
+            }
+            for (int d = 0; d < 3; ++d) {
+                auto& bin = bins[d][get_bin(p->cent(d), d)];
+                ++bin.count;
+                bin.add(tlo, thi);
+            }
+        }
+
+        auto nleaves = [] (Long n) -> Real
+        {
+            return Real((n + (STLtools::m_bvh_max_size-1)) / STLtools::m_bvh_max_size);
+        };
+
+        Real best_cost = rmax;
+        int best_dir = -1;
+        int best_bin = -1;
+        for (int d = 0; d < 3; ++d) {
+            if (scale[d] == Real(0.)) { continue; }
+
+            // right[b] is for bins b and above
+            Bin right[nbins];
+            right[nbins-1] = bins[d][nbins-1];
+            for (int b = nbins-2; b > 0; --b) {
+                right[b] = right[b+1];
+                right[b].count += bins[d][b].count;
+                right[b].add(bins[d][b].lo, bins[d][b].hi);
+            }
+
+            Bin left;
+            for (int b = 0; b < nbins-1; ++b) {
+                left.count += bins[d][b].count;
+                left.add(bins[d][b].lo, bins[d][b].hi);
+                if (left.count > 0 && right[b+1].count > 0) {
+                    Real cost = nleaves(left.count)*left.area()
+                        +       nleaves(right[b+1].count)*right[b+1].area();
+                    if (cost < best_cost) {
+                        best_cost = cost;
+                        best_dir = d;
+                        best_bin = b;
+                    }
+                }
+            }
+        }
+
+        if (best_dir < 0) { // All the centroids are at the same point.
+            return begin + (end-begin)/2;
+        }
+
+        return std::partition(begin, end, [&] (Triangle const& tri) -> bool
+                                  { return get_bin(tri.cent(best_dir), best_dir) <= best_bin; });
+    }
+
+    // Split [begin,end) into at most m_bvh_max_splits ranges, each with at
+    // most cap triangles. Range i is [bounds[i],bounds[i+1]). It returns the
+    // number of ranges.
+    int bvh_split (Triangle* begin, Triangle* end, Long cap, Triangle** bounds)
+    {
+        static_assert(STLtools::m_bvh_max_splits == 4);
+
+        // Two levels of binary splits
+        Triangle* mid = bvh_sah_split(begin, end);
+        int nsplits = 0;
+        bounds[0] = begin;
+        for (auto [b, e] : {std::make_pair(begin,mid), std::make_pair(mid,end)}) {
+            if (e-b > STLtools::m_bvh_max_size) {
+                bounds[++nsplits] = bvh_sah_split(b, e);
+            }
+            bounds[++nsplits] = e;
+        }
+
+        bool fits = true;
+        for (int i = 0; i < nsplits; ++i) {
+            fits = fits && (bounds[i+1]-bounds[i] <= cap);
+        }
+        if (fits) { return nsplits; }
+
+        // The depth of the tree would exceed the limit. So we split the
+        // triangles into ranges of equal size along the direction with
+        // the largest extent of the centroids.
+        RealVect centmin(std::numeric_limits<Real>::max());
+        RealVect centmax(std::numeric_limits<Real>::lowest());
+        for (auto const* p = begin; p != end; ++p) {
+            RealVect cent(AMREX_D_DECL(p->cent(0), p->cent(1), p->cent(2)));
+            centmin.min(cent);
+            centmax.max(cent);
+        }
+        int max_dir = (centmax-centmin).maxDir(false);
+        auto comp = [max_dir] (Triangle const& a, Triangle const& b) -> bool
+            { return a.cent(max_dir) < b.cent(max_dir); };
+
+        Long ntri = end - begin;
+        nsplits = int(std::min((ntri + (STLtools::m_bvh_max_size-1)) / STLtools::m_bvh_max_size,
+                               Long(STLtools::m_bvh_max_splits)));
+        Long tsize = ntri / nsplits;
+        Long nleft = ntri - tsize*nsplits;
+        for (int isplit = 1; isplit < nsplits; ++isplit) {
+            bounds[isplit] = begin + isplit*tsize + std::min(Long(isplit),nleft);
+            std::nth_element(bounds[isplit-1], bounds[isplit], end, comp);
+        }
+        bounds[nsplits] = end;
+        return nsplits;
+    }
+
+    // Build the BVH for triangles [begin,end) with the root at the given
+    // depth. If subtrees is not null, child subtrees with at most
+    // defer_size triangles are not built. Instead, their begin, end and
+    // depth are appended to subtrees, and the child index is set to
+    // -(1+the index of the subtree). The bounding boxes of the interior
+    // nodes are not computed in that case.
+    void bvh_build (Triangle* tri, Long begin, Long end, int depth, Vector<Node>& bvh_nodes,
+                    Vector<Long>* subtrees, Long defer_size)
+    {
+        Long ntri = end - begin;
+
+        if (ntri <= STLtools::m_bvh_max_size) {
+            bvh_nodes.emplace_back();
+            bvh_make_leaf(tri+begin, int(ntri), bvh_nodes.back());
+            return;
+        }
+
+        Triangle* bounds[STLtools::m_bvh_max_splits+1];
+        int nsplits = bvh_split(tri+begin, tri+end, bvh_capacity(depth+1), bounds);
+
+        bvh_nodes.emplace_back();
+        bvh_nodes.back().nchildren = std::int8_t(nsplits);
+        auto this_node = bvh_nodes.size()-1;
+
+        for (int isplit = 0; isplit < nsplits; ++isplit) {
+            Long cbegin = bounds[isplit] - tri;
+            Long cend = bounds[isplit+1] - tri;
+            if (subtrees && cend-cbegin > STLtools::m_bvh_max_size && cend-cbegin <= defer_size) {
+                subtrees->push_back(cbegin);
+                subtrees->push_back(cend);
+                subtrees->push_back(depth+1);
+                bvh_nodes[this_node].children[isplit] = -int(subtrees->size()/3);
+            } else {
+                bvh_nodes[this_node].children[isplit] = int(bvh_nodes.size());
+                bvh_build(tri, cbegin, cend, depth+1, bvh_nodes, subtrees, defer_size);
+            }
+        }
+
+        if (!subtrees) {
+            bvh_update_bbox(bvh_nodes[this_node], bvh_nodes.data());
+        }
+    }
+
+#ifdef AMREX_USE_MPI
+    MPI_Datatype stl_triangle_type ()
+    {
+        MPI_Datatype t;
+        MPI_Type_contiguous(int(sizeof(Triangle)), MPI_CHAR, &t);
+        MPI_Type_commit(&t);
+        return t;
+    }
+#endif
 }
 
 void
 STLtools::read_stl_file (std::string const& fname, Real scale, Array<Real,3> const& center,
                          int reverse_normal)
 {
-    Gpu::PinnedVector<Triangle> tri_pts;
-
-    if (ParallelDescriptor::IOProcessor()) {
+    int is_binary = 0;
+    if (ParallelContext::IOProcessorSub()) {
         char header[6];
         header[5] = '\0';
         {
@@ -207,69 +605,123 @@ STLtools::read_stl_file (std::string const& fname, Real scale, Array<Real,3> con
             }
             is.read(header, 5);
         }
-        int is_binary = std::strcmp(header, "solid");
-        if (is_binary) {
-            read_binary_stl_file(fname, scale, center, reverse_normal, tri_pts);
-        } else {
-            read_ascii_stl_file(fname, scale, center, reverse_normal, tri_pts);
-        }
+        is_binary = std::strcmp(header, "solid") != 0;
+    }
+    ParallelDescriptor::Bcast(&is_binary, 1, ParallelContext::IOProcessorNumberSub(),
+                              ParallelContext::CommunicatorSub());
+
+    if (is_binary) {
+        read_binary_stl_file(fname, scale, center, reverse_normal);
+        prepare_shared();
+    } else {
+        Gpu::PinnedVector<Triangle> tri_pts;
+        read_ascii_stl_file(fname, scale, center, reverse_normal, tri_pts);
+        prepare(std::move(tri_pts));
     }
-
-    prepare(std::move(tri_pts));
 }
 
+// All the processes read the file. Each node reads a contiguous range of
+// triangles into its shared memory, and then the nodes exchange their
+// ranges.
 void
 STLtools::read_binary_stl_file (std::string const& fname, Real scale,
-                                Array<Real,3> const& center, int reverse_normal,
-                                Gpu::PinnedVector<Triangle>& a_tri_pts)
+                                Array<Real,3> const& center, int reverse_normal)
 {
-    if (ParallelDescriptor::IOProcessor()) {
-        if (amrex::Verbose()) {
-            Print() << "Reading binary STL file "<< fname << "\n";
-        }
+    if (amrex::Verbose()) {
+        Print() << "Reading binary STL file "<< fname << "\n";
+    }
 
+    if (ParallelContext::IOProcessorSub()) {
         IntDescriptor uint32_descr(sizeof(uint32_t), IntDescriptor::ReverseOrder);
-        IntDescriptor uint16_descr(sizeof(uint16_t), IntDescriptor::ReverseOrder);
-        RealDescriptor real32_descr(FPC::ieee_float, FPC::reverse_float_order, 4);
 
         std::ifstream is(fname, std::istringstream::in|std::ios::binary);
         if (!is.good()) {
             amrex::Abort("STLtools::read_binary_stl_file: failed to open " + fname);
         }
 
-        char tmp[81];
-        tmp[80] = '\0';
+        char tmp[80];
         is.read(tmp, 80); // Header - 80 bytes
 
         uint32_t numtris; // uint32 - Number of triangles - 4 bytes
         amrex::readIntData<uint32_t,uint32_t>(&numtris, 1, is, uint32_descr);
         AMREX_ALWAYS_ASSERT(numtris < uint32_t(std::numeric_limits<int>::max()));
         m_num_tri = static_cast<int>(numtris);
-        // maximum number of triangles allowed for traversing the BVH tree
-        // using stack.
-        int max_tri_stack = Math::powi<m_bvh_max_stack_size-1>(m_bvh_max_splits)*m_bvh_max_size;
-        AMREX_ALWAYS_ASSERT(m_num_tri <= max_tri_stack);
-        a_tri_pts.resize(m_num_tri);
+    }
+    ParallelDescriptor::Bcast(&m_num_tri, 1, ParallelContext::IOProcessorNumberSub(),
+                              ParallelContext::CommunicatorSub());
 
-        if (amrex::Verbose()) {
-            Print() << "    Number of triangles: " << m_num_tri << "\n";
+    if (amrex::Verbose()) {
+        Print() << "    Number of triangles: " << m_num_tri << "\n";
+    }
+
+    STLNodeComm nc;
+    auto const ntri = Long(m_num_tri);
+    auto shm = std::make_shared<STLSharedMemory>
+        ((nc.rank_in_node == 0) ? ntri*sizeof(Triangle) : 0, nc);
+    m_tri_pts_shared = shm;
+    m_tri_pts_h = shm->base<Triangle>();
+
+    Long node_begin = (ntri* nc.inode   ) / nc.nnodes;
+    Long node_end   = (ntri*(nc.inode+1)) / nc.nnodes;
+    Long my_begin = node_begin + ((node_end-node_begin)* nc.rank_in_node   ) / nc.nprocs_in_node;
+    Long my_end   = node_begin + ((node_end-node_begin)*(nc.rank_in_node+1)) / nc.nprocs_in_node;
+
+    if (my_end > my_begin) {
+        RealDescriptor real32_descr(FPC::ieee_float, FPC::reverse_float_order, 4);
+
+        std::ifstream is(fname, std::istringstream::in|std::ios::binary);
+        if (!is.good()) {
+            amrex::Abort("STLtools::read_binary_stl_file: failed to open " + fname);
         }
+        // 84 bytes for the header and the number of triangles, and 50 bytes
+        // for each triangle.
+        is.seekg(std::streamoff(84 + 50*my_begin));
 
-        for (int i=0; i < m_num_tri; ++i) {
-            is.read(tmp, 50);  // 50 bytes for each triangle. Vertex 1 starts at 12 bytes.
-            Real* p = &(a_tri_pts[i].v1.x);
-            RealDescriptor::convertToNativeFormat(p, 9, tmp+12, real32_descr);
-            for (int j = 0; j < 3; ++j) {
+        static_assert(sizeof(Triangle) == sizeof(Real)*9, "sizeof(Triangle) is wrong");
+        constexpr Long chunk_size = 4096;
+        Vector<char> buffer(50*chunk_size);
+        Vector<char> vertices(36*chunk_size);
+        for (Long ibegin = my_begin; ibegin < my_end; ibegin += chunk_size) {
+            Long n = std::min(chunk_size, my_end-ibegin);
+            is.read(buffer.data(), std::streamsize(50*n));
+            if (!is.good()) {
+                amrex::Abort("STLtools::read_binary_stl_file: failed to read " + fname);
+            }
+            // The 36 bytes of the vertices start at 12 bytes.
+            for (Long i = 0; i < n; ++i) {
+                std::memcpy(vertices.data()+36*i, buffer.data()+50*i+12, 36);
+            }
+            Real* p = &(m_tri_pts_h[ibegin].v1.x);
+            RealDescriptor::convertToNativeFormat(p, 9*n, vertices.data(), real32_descr);
+            for (Long i = 0; i < 3*n; ++i) {
                 p[0] = p[0] * scale + center[0];
                 p[1] = p[1] * scale + center[1];
                 p[2] = p[2] * scale + center[2];
                 p += 3;
             }
             if (reverse_normal) {
-                std::swap(a_tri_pts[i].v1, a_tri_pts[i].v2);
+                for (Long i = ibegin; i < ibegin+n; ++i) {
+                    std::swap(m_tri_pts_h[i].v1, m_tri_pts_h[i].v2);
+                }
             }
         }
     }
+
+    shm->sync(nc);
+#ifdef AMREX_USE_MPI
+    if (nc.leaders != MPI_COMM_NULL && nc.nnodes > 1) {
+        Vector<int> counts(nc.nnodes), offsets(nc.nnodes);
+        for (int i = 0; i < nc.nnodes; ++i) {
+            offsets[i] = int((ntri*i) / nc.nnodes);
+            counts[i] = int((ntri*(i+1)) / nc.nnodes) - offsets[i];
+        }
+        MPI_Datatype tri_type = stl_triangle_type();
+        MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, m_tri_pts_h, counts.data(),
+                       offsets.data(), tri_type, nc.leaders);
+        MPI_Type_free(&tri_type);
+    }
+#endif
+    shm->sync(nc);
 }
 
 void
@@ -277,7 +729,7 @@ STLtools::read_ascii_stl_file (std::string const& fname, Real scale,
                                Array<Real,3> const& center, int reverse_normal,
                                Gpu::PinnedVector<Triangle>& a_tri_pts)
 {
-    if (ParallelDescriptor::IOProcessor()) {
+    if (ParallelContext::IOProcessorSub()) {
         if (amrex::Verbose()) {
             Print() << "Reading binary STL file "<< fname << "\n";
         }
@@ -347,43 +799,60 @@ STLtools::read_ascii_stl_file (std::string const& fname, Real scale,
 void
 STLtools::prepare (Gpu::PinnedVector<Triangle> a_tri_pts)
 {
-    BL_PROFILE("STLtools::prepare");
+    ParallelDescriptor::Bcast(&m_num_tri, 1, ParallelContext::IOProcessorNumberSub(),
+                              ParallelContext::CommunicatorSub());
+
+    STLNodeComm nc;
+    auto const ntri = Long(m_num_tri);
+    auto shm = std::make_shared<STLSharedMemory>
+        ((nc.rank_in_node == 0) ? ntri*sizeof(Triangle) : 0, nc);
+    m_tri_pts_shared = shm;
+    m_tri_pts_h = shm->base<Triangle>();
+
+    if (ParallelContext::IOProcessorSub()) {
+        std::memcpy(m_tri_pts_h, a_tri_pts.data(), ntri*sizeof(Triangle));
+        Gpu::PinnedVector<Triangle>().swap(a_tri_pts);
+    }
 
-    ParallelDescriptor::Bcast(&m_num_tri, 1);
-    if (!ParallelDescriptor::IOProcessor()) {
-        a_tri_pts.resize(m_num_tri);
+#ifdef AMREX_USE_MPI
+    if (nc.leaders != MPI_COMM_NULL && nc.nnodes > 1) {
+        // The I/O processor is rank 0 of the leaders.
+        MPI_Datatype tri_type = stl_triangle_type();
+        MPI_Bcast(m_tri_pts_h, m_num_tri, tri_type, 0, nc.leaders);
+        MPI_Type_free(&tri_type);
     }
-    ParallelDescriptor::Bcast((char*)(a_tri_pts.dataPtr()), m_num_tri*sizeof(Triangle));
+#endif
+    shm->sync(nc);
+
+    prepare_shared();
+}
+
+void
+STLtools::prepare_shared ()
+{
+    BL_PROFILE("STLtools::prepare");
+
+    AMREX_ALWAYS_ASSERT(m_num_tri > 0);
 
-    Gpu::PinnedVector<Node> bvh_nodes;
     if (m_bvh_optimization) {
-        BL_PROFILE("STLtools::build_bvh");
-        std::size_t nnodes = 0;
-        bvh_size(int(a_tri_pts.size()), nnodes);
-        bvh_nodes.reserve(nnodes);
-        build_bvh(a_tri_pts.data(), a_tri_pts.data()+a_tri_pts.size(), bvh_nodes);
-#ifdef AMREX_USE_GPU
-        m_bvh_nodes.resize(bvh_nodes.size());
-        Gpu::copyAsync(Gpu::hostToDevice, bvh_nodes.begin(), bvh_nodes.end(),
-                       m_bvh_nodes.begin());
-#else
-        m_bvh_nodes = std::move(bvh_nodes);
-#endif
+        build_bvh();
     }
 
-    auto const tri0 = a_tri_pts[0];
+    auto const tri0 = m_tri_pts_h[0];
 
 #ifdef AMREX_USE_GPU
     m_tri_pts_d.resize(m_num_tri);
-    Gpu::copyAsync(Gpu::hostToDevice, a_tri_pts.begin(), a_tri_pts.end(),
+    Gpu::copyAsync(Gpu::hostToDevice, m_tri_pts_h, m_tri_pts_h+m_num_tri,
                    m_tri_pts_d.begin());
-#else
-    m_tri_pts_d = std::move(a_tri_pts);
 #endif
-    Triangle const* tri_pts = m_tri_pts_d.data();
+    Triangle const* tri_pts = triPoints();
 
-    m_tri_normals_d.resize(m_num_tri);
-    XDim3* tri_norm = m_tri_normals_d.data();
+    // The BVH nodes have their own normals.
+    XDim3* tri_norm = nullptr;
+    if (!m_bvh_optimization) {
+        m_tri_normals_d.resize(m_num_tri);
+        tri_norm = m_tri_normals_d.data();
+    }
 
     ReduceOps<ReduceOpMin,ReduceOpMin,ReduceOpMin,ReduceOpMax,ReduceOpMax,ReduceOpMax> reduce_op;
     ReduceData<Real,Real,Real,Real,Real,Real> reduce_data(reduce_op);
@@ -391,7 +860,9 @@ STLtools::prepare (Gpu::PinnedVector<Triangle> a_tri_pts)
     reduce_op.eval(m_num_tri, reduce_data,
                    [=] AMREX_GPU_DEVICE (int i) -> ReduceTuple
                    {
-                       tri_norm[i] = triangle_norm(tri_pts[i]);
+                       if (tri_norm) {
+                           tri_norm[i] = triangle_norm(tri_pts[i]);
+                       }
                        return {amrex::min(tri_pts[i].v1.x,
                                           tri_pts[i].v2.x,
                                           tri_pts[i].v3.x),
@@ -517,107 +988,144 @@ STLtools::prepare (Gpu::PinnedVector<Triangle> a_tri_pts)
         });
 
     m_boundry_is_outside = num_isects % 2 == 0;
+
+    if (m_bvh_optimization) {
+        // The triangles are also stored in the BVH nodes.
+        Gpu::DeviceVector<Triangle>().swap(m_tri_pts_d);
+    }
+
+    // The host copy of the triangles is only used on the CPU without BVH.
+    bool keep_host_triangles = !m_bvh_optimization;
+#ifdef AMREX_USE_GPU
+    keep_host_triangles = false;
+#endif
+    if (!keep_host_triangles) {
+        m_tri_pts_h = nullptr;
+        m_tri_pts_shared.reset();
+    }
 }
 
+// The top of the tree is built by the first process on the node. The
+// subtrees below it are built by all the processes on the node and their
+// threads, and are then stored in the shared memory of the node.
 void
-STLtools::build_bvh (Triangle* begin, Triangle* end, Gpu::PinnedVector<Node>& bvh_nodes)
+STLtools::build_bvh ()
 {
-    auto ntri = int(end - begin);
+    BL_PROFILE("STLtools::build_bvh");
+
+    // maximum number of triangles allowed for traversing the BVH tree
+    // using stack.
+    AMREX_ALWAYS_ASSERT(Long(m_num_tri) <= bvh_capacity(0));
+
+    STLNodeComm nc;
+    auto const ntri = Long(m_num_tri);
+    int nworkers = nc.nprocs_in_node * OpenMP::get_max_threads();
+    bool parallel_build = nworkers > 1;
+    Long defer_size = std::max(ntri / (Long(16)*nworkers), Long(256));
+
+    // The triangles are sorted in place, first by the top of the tree and
+    // then by the subtrees.
+    auto const& tri_shm = *static_cast<STLSharedMemory const*>(m_tri_pts_shared.get());
+
+    Vector<Node> top_nodes;
+    Vector<Long> subtrees;
+    if (nc.rank_in_node == 0) {
+        bvh_build(m_tri_pts_h, 0, ntri, 0, top_nodes, parallel_build ? &subtrees : nullptr,
+                  defer_size);
+    }
+    tri_shm.sync(nc);
+
+    int nsubtrees = int(subtrees.size()/3);
+#ifdef AMREX_USE_MPI
+    if (nc.node != MPI_COMM_NULL) {
+        MPI_Bcast(&nsubtrees, 1, MPI_INT, 0, nc.node);
+        subtrees.resize(std::size_t(nsubtrees)*3);
+        MPI_Bcast(subtrees.data(), nsubtrees*3, ParallelDescriptor::Mpi_typemap<Long>::type(),
+                  0, nc.node);
+    }
+#endif
 
-    if (ntri <= m_bvh_max_size) {
-        // This is a leaf node
-        bvh_nodes.push_back(Node());
-        auto& node = bvh_nodes.back();
-        auto& bbox = node.boundingbox;
-        for (int tr = 0; tr < ntri; ++tr) {
-            auto const& tri = begin[tr];
-            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
-                auto const& [xmin,xmax] = tri.minmax(idim);
-                bbox.setLo(idim,amrex::min(xmin, bbox.lo(idim)));
-                bbox.setHi(idim,amrex::max(xmax, bbox.hi(idim)));
-            }
-            node.triangles[tr] = tri;
-            node.trinorm[tr] = triangle_norm(tri);
-        }
-#ifdef AMREX_USE_FLOAT
-        constexpr Real eps = Real(1.e-5);
-#else
-        constexpr Real eps = Real(1.e-10);
+    Vector<int> my_subtrees;
+    for (int i = nc.rank_in_node; i < nsubtrees; i += nc.nprocs_in_node) {
+        my_subtrees.push_back(i);
+    }
+    Vector<Vector<Node>> my_nodes(my_subtrees.size());
+#ifdef AMREX_USE_OMP
+#pragma omp parallel for schedule(dynamic)
 #endif
-        Real sml = eps*std::max({AMREX_D_DECL(bbox.length(0),
-                                              bbox.length(1),
-                                              bbox.length(2))});
-        // Make bounding box slightly bigger for robustness.
-        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
-            bbox.setLo(idim,bbox.lo(idim)-sml);
-            bbox.setHi(idim,bbox.hi(idim)+sml);
-        }
-        node.ntriangles = int(ntri); // NOLINT
-        return;
+    for (int i = 0; i < int(my_subtrees.size()); ++i) {
+        Long const* st = subtrees.data() + std::size_t(my_subtrees[i])*3;
+        bvh_build(m_tri_pts_h, st[0], st[1], int(st[2]), my_nodes[i], nullptr, 0);
     }
 
-    RealVect centmin(std::numeric_limits<Real>::max());
-    RealVect centmax(std::numeric_limits<Real>::lowest());
-    for (auto* p = begin; p != end; ++p) {
-        RealVect cent(AMREX_D_DECL(p->cent(0), p->cent(1), p->cent(2)));
-        centmin.min(cent);
-        centmax.max(cent);
+    Long my_nnodes = top_nodes.size();
+    for (auto const& v : my_nodes) {
+        my_nnodes += v.size();
     }
-    int max_dir = (centmax-centmin).maxDir(false);
-    std::sort(begin, end, [max_dir] (Triangle const& a, Triangle const& b) -> bool
-                              { return a.cent(max_dir) < b.cent(max_dir); });
-
-    int nsplits = std::min((ntri + (m_bvh_max_size-1)) / m_bvh_max_size, m_bvh_max_splits);
-    int tsize = ntri / nsplits;
-    int nleft = ntri - tsize*nsplits;
-
-    bvh_nodes.push_back(Node());
-    bvh_nodes.back().nchildren = std::int8_t(nsplits);
-    auto this_node = bvh_nodes.size()-1;
-
-    for (int isplit = 0; isplit < nsplits; ++isplit) {
-        int tbegin, tend;
-        if (isplit < nleft) {
-            tbegin = isplit * (tsize+1);
-            tend = tbegin + tsize + 1;
+    auto shm = std::make_shared<STLSharedMemory>(my_nnodes*sizeof(Node), nc);
+    Node* bvh_nodes = shm->base<Node>();
+
+    // The subtrees use local indices. They are shifted by the offsets of
+    // their roots.
+    Vector<int> subtree_root(nsubtrees, 0);
+    Long offset = (shm->mine<Node>() - bvh_nodes) + Long(top_nodes.size());
+    for (int i = 0; i < int(my_subtrees.size()); ++i) {
+        int root = int(offset);
+        subtree_root[my_subtrees[i]] = root;
+        for (auto node : my_nodes[i]) {
+            for (int ichild = 0; ichild < node.nchildren; ++ichild) {
+                node.children[ichild] += root;
+            }
+            bvh_nodes[offset++] = node;
+        }
+        Vector<Node>().swap(my_nodes[i]);
+    }
+    tri_shm.sync(nc);
+    shm->sync(nc);
+
+    Long nnodes = offset;
+#ifdef AMREX_USE_MPI
+    if (nc.node != MPI_COMM_NULL) {
+        if (nc.rank_in_node == 0) {
+            MPI_Reduce(MPI_IN_PLACE, subtree_root.data(), nsubtrees, MPI_INT, MPI_SUM, 0, nc.node);
         } else {
-            tbegin = isplit * tsize + nleft;
-            tend = tbegin + tsize;
+            MPI_Reduce(subtree_root.data(), nullptr, nsubtrees, MPI_INT, MPI_SUM, 0, nc.node);
         }
-        bvh_nodes[this_node].children[isplit] = int(bvh_nodes.size());
-        build_bvh(begin+tbegin, begin+tend, bvh_nodes);
+        MPI_Allreduce(MPI_IN_PLACE, &nnodes, 1, ParallelDescriptor::Mpi_typemap<Long>::type(),
+                      MPI_MAX, nc.node);
     }
+#endif
 
-    // update bounding box
-    auto& node = bvh_nodes[this_node];
-    for (int ichild = 0; ichild < node.nchildren; ++ichild) {
-        int inode = node.children[ichild];
-        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
-            auto lo = node.boundingbox.lo(idim);
-            auto hi = node.boundingbox.hi(idim);
-            auto clo = bvh_nodes[inode].boundingbox.lo(idim);
-            auto chi = bvh_nodes[inode].boundingbox.hi(idim);
-            node.boundingbox.setLo(idim, std::min(lo,clo));
-            node.boundingbox.setHi(idim, std::max(hi,chi));
+    if (nc.rank_in_node == 0) {
+        for (int i = int(top_nodes.size())-1; i >= 0; --i) {
+            auto& node = top_nodes[i];
+            if (node.nchildren > 0) {
+                for (int ichild = 0; ichild < node.nchildren; ++ichild) {
+                    if (node.children[ichild] < 0) {
+                        node.children[ichild] = subtree_root[-node.children[ichild]-1];
+                    }
+                }
+                if (parallel_build) {
+                    bvh_update_bbox(node, bvh_nodes);
+                }
+            }
+            bvh_nodes[i] = node;
         }
     }
-}
-
-void
-STLtools::bvh_size (int ntri, std::size_t& nnodes)
-{
-    ++nnodes;
-
-    if (ntri <= m_bvh_max_size) { return; } // This is a leaf node
+    shm->sync(nc);
 
-    int nsplits = std::min((ntri + (m_bvh_max_size-1)) / m_bvh_max_size, m_bvh_max_splits);
-    int tsize = ntri / nsplits;
-    int nleft = ntri - tsize*nsplits;
-
-    for (int isplit = 0; isplit < nsplits; ++isplit) {
-        int child_size = (isplit < nleft) ? (tsize+1) : tsize;
-        bvh_size(child_size, nnodes);
+    if (amrex::Verbose() > 0) {
+        amrex::Print() << "    Number of BVH nodes: " << nnodes << '\n';
     }
+
+#ifdef AMREX_USE_GPU
+    m_bvh_nodes.resize(nnodes);
+    Gpu::copyAsync(Gpu::hostToDevice, bvh_nodes, bvh_nodes+nnodes, m_bvh_nodes.begin());
+    Gpu::streamSynchronize();
+#else
+    m_bvh_nodes_h = bvh_nodes;
+    m_bvh_nodes_shared = shm;
+#endif
 }
 
 void
@@ -636,7 +1144,7 @@ STLtools::fill (MultiFab& mf, IntVect const& nghost, Geometry const& geom,
                                  ixt.cellCentered(1) ? 0.5_rt : 0.0_rt,
                                  ixt.cellCentered(2) ? 0.5_rt : 0.0_rt));
 
-    const Triangle* tri_pts = m_tri_pts_d.data();
+    const Triangle* tri_pts = triPoints();
     XDim3 ptmin = m_ptmin;
     XDim3 ptmax = m_ptmax;
     XDim3 ptref = m_ptref;
@@ -644,7 +1152,7 @@ STLtools::fill (MultiFab& mf, IntVect const& nghost, Geometry const& geom,
     Real other_value     = m_boundry_is_outside ?  inside_value : outside_value;
 
     auto const& ma = mf.arrays();
-    auto const* bvh_root = m_bvh_nodes.data();
+    auto const* bvh_root = bvhRoot();
 
     enum bvh_opt_options : int { no_bvh, yes_bvh };
     int bvh_opt_runtime_option = m_bvh_optimization ? yes_bvh : no_bvh;
@@ -730,13 +1238,13 @@ STLtools::getBoxType (Box const& box, Geometry const& geom, RunOn) const
     else
     {
         int num_triangles = m_num_tri;
-        const Triangle* tri_pts = m_tri_pts_d.data();
+        const Triangle* tri_pts = triPoints();
         XDim3 ptmin = m_ptmin;
         XDim3 ptmax = m_ptmax;
         XDim3 ptref = m_ptref;
         int ref_value = m_boundry_is_outside ? 1 : 0;
 
-        auto const* bvh_root = m_bvh_nodes.data();
+        auto const* bvh_root = bvhRoot();
 
         ReduceOps<ReduceOpSum> reduce_op;
         ReduceData<int> reduce_data(reduce_op);
@@ -812,14 +1320,14 @@ STLtools::fillFab (BaseFab<Real>& levelset, const Geometry& geom, RunOn, Box con
     const auto plo = geom.ProbLoArray();
     const auto dx  = geom.CellSizeArray();
 
-    const Triangle* tri_pts = m_tri_pts_d.data();
+    const Triangle* tri_pts = triPoints();
     XDim3 ptmin = m_ptmin;
     XDim3 ptmax = m_ptmax;
     XDim3 ptref = m_ptref;
     Real reference_value = m_boundry_is_outside ? -1.0_rt :  1.0_rt;
     Real other_value     = m_boundry_is_outside ?  1.0_rt : -1.0_rt;
 
-    auto const* bvh_root = m_bvh_nodes.data();
+    auto const* bvh_root = bvhRoot();
 
     auto const& a = levelset.array();
     const Box& bx = levelset.box();
@@ -883,9 +1391,9 @@ STLtools::getIntercept (Array<Array4<Real>,AMREX_SPACEDIM> const& inter_arr,
     const auto plo = geom.ProbLoArray();
     const auto dx  = geom.CellSizeArray();
 
-    const Triangle* tri_pts = m_tri_pts_d.data();
+    const Triangle* tri_pts = triPoints();
     const XDim3* tri_norm = m_tri_normals_d.data();
-    const Node* bvh_root = m_bvh_nodes.data();
+    const Node* bvh_root = bvhRoot();
 
     enum bvh_opt_options : int { no_bvh, yes_bvh };
     int bvh_opt_runtime_option = m_bvh_optimization ? yes_bvh : no_bvh;
@@ -0,0 +1,229 @@
+#include <AMReX_MultiCutCellList.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_EB2_Level.H>
+#include <AMReX_MultiCutFab.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Reduce.H>
+#include <AMReX_Scan.H>
+
+namespace amrex {
+
+namespace {
+
+void pack_cell_data (CutCellList const& list, Real* data, Array4<Real const> const& src,
+                     int comp, int ncomp)
+{
+    const int n = list.m_size;
+    const Box box = list.m_box;
+    int const* pidx = list.m_index;
+    Real* p = data + comp*n;
+    ParallelFor(n, [=] AMREX_GPU_DEVICE (int m) noexcept
+    {
+        IntVect const& iv = box.atOffset(pidx[m]);
+        for (int nc = 0; nc < ncomp; ++nc) {
+            p[nc*n+m] = src(iv,nc);
+        }
+    });
+}
+
+void pack_face_data (CutCellList const& list, Real* data,
+                     GpuArray<Array4<Real const>,AMREX_SPACEDIM> const& src,
+                     int comp, int ncomp)
+{
+    const int n = list.m_size;
+    const Box box = list.m_box;
+    int const* pidx = list.m_index;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        auto const& a = src[idim];
+        const IntVect e = IntVect::TheDimensionVector(idim);
+        Real* p = data + (comp+2*idim*ncomp)*n;
+        ParallelFor(n, [=] AMREX_GPU_DEVICE (int m) noexcept
+        {
+            IntVect const& iv = box.atOffset(pidx[m]);
+            for (int nc = 0; nc < ncomp; ++nc) {
+                p[       nc *n+m] = a(iv  ,nc);
+                p[(ncomp+nc)*n+m] = a(iv+e,nc);
+            }
+        });
+    }
+}
+
+}
+
+MultiCutCellList::MultiCutCellList (const EBFArrayBoxFactory& factory, int ngrow)
+{
+    define(factory, ngrow);
+}
+
+void
+MultiCutCellList::define (const EBFArrayBoxFactory& factory, int ngrow)
+{
+    BL_PROFILE("MultiCutCellList::define()");
+
+    auto const& flags = factory.getMultiEBCellFlagFab();
+    AMREX_ALWAYS_ASSERT(ngrow >= 0 && ngrow <= flags.nGrow());
+
+    m_ngrow = ngrow;
+    const int nlocal = flags.local_size();
+    m_lists.clear();
+    m_lists.resize(nlocal);
+    m_index.clear();
+    m_index.resize(nlocal);
+    m_data.clear();
+    m_data.resize(nlocal);
+
+    for (MFIter mfi(flags); mfi.isValid(); ++mfi)
+    {
+        const int li = mfi.LocalIndex();
+        const Box& bx = amrex::grow(mfi.validbox(), ngrow);
+        CutCellList& list = m_lists[li];
+        list.m_box = bx;
+        if (flags[mfi].getType(bx) != FabType::singlevalued) { continue; }
+
+        auto const& flag = flags.const_array(mfi);
+        const auto npts = static_cast<int>(bx.numPts());
+        const int n = Reduce::Sum<int>(npts, [=] AMREX_GPU_DEVICE (int i) noexcept -> int
+        {
+            return flag(bx.atOffset(i)).isSingleValued() ? 1 : 0;
+        });
+
+        m_index[li].resize(n);
+        int* pidx = m_index[li].data();
+        Scan::PrefixSum<int>(npts,
+            [=] AMREX_GPU_DEVICE (int i) noexcept -> int
+            {
+                return flag(bx.atOffset(i)).isSingleValued() ? 1 : 0;
+            },
+            [=] AMREX_GPU_DEVICE (int i, int const& s) noexcept
+            {
+                if (flag(bx.atOffset(i)).isSingleValued()) { pidx[s] = i; }
+            },
+            Scan::Type::exclusive, Scan::noRetSum);
+
+        m_data[li].resize(std::size_t(n)*CutCellList::ncomp);
+        list.m_index = pidx;
+        list.m_data = m_data[li].data();
+        list.m_size = n;
+    }
+
+    if (factory.isAllRegular()) { return; }
+
+    auto pack_cells = [&] (auto const& src, int comp, int ncomp)
+    {
+        for (MFIter mfi(flags); mfi.isValid(); ++mfi) {
+            const int li = mfi.LocalIndex();
+            if (m_lists[li].m_size > 0) {
+                pack_cell_data(m_lists[li], m_data[li].data(), src.const_array(mfi),
+                               comp, ncomp);
+            }
+        }
+        Gpu::streamSynchronize();
+    };
+
+    auto pack_faces = [&] (auto const& src, int comp, int ncomp)
+    {
+        for (MFIter mfi(flags); mfi.isValid(); ++mfi) {
+            const int li = mfi.LocalIndex();
+            if (m_lists[li].m_size > 0) {
+                GpuArray<Array4<Real const>,AMREX_SPACEDIM> a
+                    {AMREX_D_DECL(src[0]->const_array(mfi),
+                                  src[1]->const_array(mfi),
+                                  src[2]->const_array(mfi))};
+                pack_face_data(m_lists[li], m_data[li].data(), a, comp, ncomp);
+            }
+        }
+        Gpu::streamSynchronize();
+    };
+
+    const EBSupport support = factory.getEBSupport();
+    const bool has_volume = support >= EBSupport::volume
+        && factory.getCentroid().nGrow() >= ngrow;
+    const bool has_full = support == EBSupport::full
+        && factory.getBndryCent().nGrow() >= ngrow;
+
+    EB2::Level const* level = factory.getEBLevel();
+    AMREX_ALWAYS_ASSERT(has_full || level != nullptr);
+
+    const BoxArray& ba = flags.boxArray();
+    const DistributionMapping& dm = flags.DistributionMap();
+    const Geometry& geom = factory.Geom();
+
+    // Without the data in the factory, each quantity is filled into a
+    // temporary MultiFab and packed before the next one is filled.
+    if (has_volume) {
+        pack_cells(factory.getVolFrac(), CutCellList::volfrac, 1);
+        pack_cells(factory.getCentroid(), CutCellList::centroid, AMREX_SPACEDIM);
+    } else {
+        {
+            MultiFab tmp(ba, dm, 1, ngrow);
+            level->fillVolFrac(tmp, geom);
+            pack_cells(tmp, CutCellList::volfrac, 1);
+        }
+        {
+            MultiFab tmp(ba, dm, AMREX_SPACEDIM, ngrow);
+            level->fillCentroid(tmp, geom);
+            pack_cells(tmp, CutCellList::centroid, AMREX_SPACEDIM);
+        }
+    }
+
+    if (has_full) {
+        pack_cells(factory.getBndryCent(), CutCellList::bndrycent, AMREX_SPACEDIM);
+        pack_cells(factory.getBndryNormal(), CutCellList::bndrynorm, AMREX_SPACEDIM);
+        pack_cells(factory.getBndryArea(), CutCellList::bndryarea, 1);
+        pack_faces(factory.getAreaFrac(), CutCellList::areafrac, 1);
+        pack_faces(factory.getFaceCent(), CutCellList::facecent, AMREX_SPACEDIM-1);
+    } else {
+        {
+            MultiFab tmp(ba, dm, AMREX_SPACEDIM, ngrow);
+            level->fillBndryCent(tmp, geom);
+            pack_cells(tmp, CutCellList::bndrycent, AMREX_SPACEDIM);
+            level->fillBndryNorm(tmp, geom);
+            pack_cells(tmp, CutCellList::bndrynorm, AMREX_SPACEDIM);
+        }
+        {
+            MultiFab tmp(ba, dm, 1, ngrow);
+            level->fillBndryArea(tmp, geom);
+            pack_cells(tmp, CutCellList::bndryarea, 1);
+        }
+        auto fill_faces = [&] (int ncomp, auto const& fill, int comp)
+        {
+            Array<MultiFab,AMREX_SPACEDIM> tmp;
+            Array<MultiFab*,AMREX_SPACEDIM> ptmp;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                tmp[idim].define(amrex::convert(ba, IntVect::TheDimensionVector(idim)), dm,
+                                 ncomp, ngrow);
+                ptmp[idim] = &tmp[idim];
+            }
+            fill(ptmp);
+            pack_faces(ptmp, comp, ncomp);
+        };
+        fill_faces(1, [&] (Array<MultiFab*,AMREX_SPACEDIM> const& a)
+                   { level->fillAreaFrac(a, geom); }, CutCellList::areafrac);
+#if (AMREX_SPACEDIM > 1)
+        fill_faces(AMREX_SPACEDIM-1, [&] (Array<MultiFab*,AMREX_SPACEDIM> const& a)
+                   { level->fillFaceCent(a, geom); }, CutCellList::facecent);
+#endif
+    }
+}
+
+Long
+MultiCutCellList::numCutCells () const noexcept
+{
+    Long r = 0;
+    for (auto const& list : m_lists) {
+        r += list.m_size;
+    }
+    return r;
+}
+
+Long
+MultiCutCellList::nBytes () const noexcept
+{
+    Long r = 0;
+    for (int li = 0; li < local_size(); ++li) {
+        r += Long(m_index[li].size()*sizeof(int) + m_data[li].size()*sizeof(Real));
+    }
+    return r;
+}
+
+}
@@ -1,7 +1,13 @@
 #include <AMReX_FFT.H>
 #include <AMReX_FFT_Helper.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Utility.H>
 
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <map>
+#include <memory>
 
 namespace amrex::FFT
 {
@@ -11,6 +17,7 @@ namespace
     bool s_initialized = false;
     std::map<Key, PlanD> s_plans_d;
     std::map<Key, PlanF> s_plans_f;
+    std::string s_wisdom_file;
 }
 
 void Initialize ()
@@ -22,6 +29,12 @@ void Initialize ()
 #if defined(AMREX_USE_HIP) && defined(AMREX_USE_FFT)
         AMREX_ROCFFT_SAFE_CALL(rocfft_setup());
 #endif
+
+        ParmParse pp("fft");
+        pp.query("wisdom_file", s_wisdom_file);
+        if (!s_wisdom_file.empty()) {
+            ImportWisdom(s_wisdom_file);
+        }
     }
 
     amrex::ExecOnFinalize(amrex::FFT::Finalize);
@@ -33,6 +46,11 @@ void Finalize ()
     {
         s_initialized = false;
 
+        if (!s_wisdom_file.empty()) {
+            ExportWisdom(s_wisdom_file);
+            s_wisdom_file.clear();
+        }
+
         Clear();
 
 #if defined(AMREX_USE_HIP) && defined(AMREX_USE_FFT)
@@ -80,6 +98,100 @@ void add_vendor_plan_f (Key const& key, PlanF plan)
     s_plans_f[key] = plan;
 }
 
+bool ImportWisdom (std::string const& filename)
+{
+#if defined(AMREX_USE_GPU)
+    amrex::ignore_unused(filename);
+    return false;
+#else
+    BL_PROFILE("FFT::ImportWisdom");
+
+    // The file has double and single precision wisdom separated by '\0'.
+    int file_exists = 0;
+    if (ParallelDescriptor::IOProcessor()) {
+        file_exists = amrex::FileExists(filename);
+    }
+    ParallelDescriptor::Bcast(&file_exists, 1, ParallelDescriptor::IOProcessorNumber());
+    if (!file_exists) { return false; }
+
+    Vector<char> buf;
+    ParallelDescriptor::ReadAndBcastFile(filename, buf);
+    buf.push_back('\0');
+    buf.push_back('\0');
+
+    char const* wisdom_d = buf.data();
+    char const* wisdom_f = wisdom_d + std::strlen(wisdom_d) + 1;
+
+    bool r = (fftw_import_wisdom_from_string(wisdom_d) != 0);
+    if (*wisdom_f != '\0') {
+        r = (fftwf_import_wisdom_from_string(wisdom_f) != 0) && r;
+    }
+    if (!r) {
+        amrex::Warning("FFT::ImportWisdom: failed to import "+filename);
+    }
+    return r;
+#endif
+}
+
+void ExportWisdom (std::string const& filename)
+{
+#if defined(AMREX_USE_GPU)
+    amrex::ignore_unused(filename);
+#else
+    BL_PROFILE("FFT::ExportWisdom");
+
+    auto to_string = [] (char* p) -> std::string
+    {
+        std::string r = p ? std::string(p) : std::string();
+        std::free(p); // NOLINT(cppcoreguidelines-no-malloc)
+        return r;
+    };
+
+    std::string local = to_string(fftw_export_wisdom_to_string());
+    local.push_back('\0');
+    local.append(to_string(fftwf_export_wisdom_to_string()));
+    local.push_back('\0');
+
+    // Different processes may have planned different shapes. We merge
+    // them on the I/O process by importing everything there.
+    int const ioproc = ParallelDescriptor::IOProcessorNumber();
+    auto sizes = ParallelDescriptor::Gather(int(local.size()), ioproc);
+    std::vector<int> offsets;
+    Vector<char> all;
+    if (ParallelDescriptor::IOProcessor()) {
+        offsets.resize(sizes.size(), 0);
+        for (int i = 1, N = int(sizes.size()); i < N; ++i) {
+            offsets[i] = offsets[i-1] + sizes[i-1];
+        }
+        all.resize(offsets.back() + sizes.back());
+    }
+    ParallelDescriptor::Gatherv(local.data(), int(local.size()), all.data(),
+                                sizes, offsets, ioproc);
+
+    if (ParallelDescriptor::IOProcessor()) {
+        for (int i = 0, N = int(sizes.size()); i < N; ++i) {
+            char const* wisdom_d = all.data() + offsets[i];
+            char const* wisdom_f = wisdom_d + std::strlen(wisdom_d) + 1;
+            fftw_import_wisdom_from_string(wisdom_d);
+            if (*wisdom_f != '\0') {
+                fftwf_import_wisdom_from_string(wisdom_f);
+            }
+        }
+        local = to_string(fftw_export_wisdom_to_string());
+        local.push_back('\0');
+        local.append(to_string(fftwf_export_wisdom_to_string()));
+
+        std::unique_ptr<std::FILE, int(*)(std::FILE*)>
+            fp(std::fopen(filename.c_str(), "wb"), &std::fclose);
+        if (fp) {
+            std::fwrite(local.data(), 1, local.size(), fp.get());
+        } else {
+            amrex::Warning("FFT::ExportWisdom: failed to open "+filename);
+        }
+    }
+#endif
+}
+
 }
 
 namespace amrex::FFT::detail
@@ -1,6 +1,8 @@
 #include <AMReX_ParticleCommunication.H>
 #include <AMReX_ParallelDescriptor.H>
 
+#include <utility>
+
 namespace amrex {
 
 void ParticleCopyOp::clear ()
@@ -31,6 +33,138 @@ void ParticleCopyOp::resize (int gid, int lev, int size)
     m_periodic_shift[lev][gid].resize(size);
 }
 
+ParticleCopyPlanCache::~ParticleCopyPlanCache ()
+{
+    clear();
+}
+
+ParticleCopyPlanCache::ParticleCopyPlanCache (ParticleCopyPlanCache&& rhs) noexcept
+    : m_procs(std::move(rhs.m_procs)),
+      m_is_neighbor(std::move(rhs.m_is_neighbor)),
+      m_idle(std::move(rhs.m_idle)),
+      m_parent_comm(std::exchange(rhs.m_parent_comm, MPI_COMM_NULL)),
+      m_graph_comm(std::exchange(rhs.m_graph_comm, MPI_COMM_NULL)),
+      m_num_updates(rhs.m_num_updates),
+      m_max_idle(rhs.m_max_idle)
+{}
+
+ParticleCopyPlanCache& ParticleCopyPlanCache::operator= (ParticleCopyPlanCache&& rhs) noexcept
+{
+    if (this != &rhs) {
+        clear();
+        m_procs = std::move(rhs.m_procs);
+        m_is_neighbor = std::move(rhs.m_is_neighbor);
+        m_idle = std::move(rhs.m_idle);
+        m_parent_comm = std::exchange(rhs.m_parent_comm, MPI_COMM_NULL);
+        m_graph_comm = std::exchange(rhs.m_graph_comm, MPI_COMM_NULL);
+        m_num_updates = rhs.m_num_updates;
+        m_max_idle = rhs.m_max_idle;
+    }
+    return *this;
+}
+
+void ParticleCopyPlanCache::clear ()
+{
+#ifdef AMREX_USE_MPI
+    if (m_graph_comm != MPI_COMM_NULL) {
+        int finalized = 0;
+        MPI_Finalized(&finalized);
+        if (!finalized) { MPI_Comm_free(&m_graph_comm); }
+    }
+#endif
+    m_graph_comm = MPI_COMM_NULL;
+    m_parent_comm = MPI_COMM_NULL;
+    m_procs.clear();
+    m_is_neighbor.clear();
+    m_idle.clear();
+}
+
+bool ParticleCopyPlanCache::isValid (MPI_Comm comm) const
+{
+    return (m_graph_comm != MPI_COMM_NULL) && (m_parent_comm == comm)
+        && (static_cast<int>(m_is_neighbor.size()) == ParallelDescriptor::NProcs(comm));
+}
+
+bool ParticleCopyPlanCache::needsPrune () const
+{
+    for (int i : m_procs) {
+        if (m_idle[i] >= m_max_idle) { return true; }
+    }
+    return false;
+}
+
+void ParticleCopyPlanCache::recordCounts (const Vector<Long>& Snds, const Vector<Long>& Rcvs)
+{
+    for (int i : m_procs) {
+        if (Snds[i] > 0 || Rcvs[i] > 0) {
+            m_idle[i] = 0;
+        } else {
+            ++m_idle[i];
+        }
+    }
+}
+
+void ParticleCopyPlanCache::update (MPI_Comm comm, const Vector<Long>& Snds, const Vector<Long>& Rcvs)
+{
+    BL_PROFILE("ParticleCopyPlanCache::update");
+
+#ifdef AMREX_USE_MPI
+    const int NProcs = ParallelDescriptor::NProcs(comm);
+    const int MyProc = ParallelDescriptor::MyProc(comm);
+
+    if (!isValid(comm)) {
+        clear();
+        m_is_neighbor.resize(NProcs, 0);
+        m_idle.resize(NProcs, 0);
+    } else {
+        recordCounts(Snds, Rcvs);
+    }
+
+    for (int i = 0; i < NProcs; ++i) {
+        if (i != MyProc && (Snds[i] > 0 || Rcvs[i] > 0)) {
+            m_is_neighbor[i] = 1;
+            m_idle[i] = 0;
+        }
+    }
+
+    buildGraph(comm);
+#else
+    amrex::ignore_unused(comm,Snds,Rcvs);
+#endif
+}
+
+void ParticleCopyPlanCache::prune (MPI_Comm comm)
+{
+    BL_PROFILE("ParticleCopyPlanCache::prune");
+    buildGraph(comm);
+}
+
+void ParticleCopyPlanCache::buildGraph (MPI_Comm comm)
+{
+#ifdef AMREX_USE_MPI
+    if (m_graph_comm != MPI_COMM_NULL) { MPI_Comm_free(&m_graph_comm); }
+
+    m_procs.clear();
+    for (int i = 0; i < static_cast<int>(m_is_neighbor.size()); ++i) {
+        if (m_is_neighbor[i] && m_idle[i] >= m_max_idle) {
+            m_is_neighbor[i] = 0;
+            m_idle[i] = 0;
+        }
+        if (m_is_neighbor[i]) { m_procs.push_back(i); }
+    }
+
+    const int n = static_cast<int>(m_procs.size());
+    BL_MPI_REQUIRE( MPI_Dist_graph_create_adjacent(comm,
+                                                   n, m_procs.data(), MPI_UNWEIGHTED,
+                                                   n, m_procs.data(), MPI_UNWEIGHTED,
+                                                   MPI_INFO_NULL, 0, &m_graph_comm) );
+    m_parent_comm = comm;
+    ++m_num_updates;
+#else
+    amrex::ignore_unused(comm);
+#endif
+}
+
 void ParticleCopyPlan::clear ()
 {
     m_dst_indices.clear();
@@ -262,8 +396,74 @@ void ParticleCopyPlan::buildMPIFinish (const ParticleBufferMap& map) // NOLINT(r
 void ParticleCopyPlan::doHandShake (const Vector<Long>& Snds, Vector<Long>& Rcvs) const // NOLINT(readability-convert-member-functions-to-static)
 {
     BL_PROFILE("ParticleCopyPlan::doHandShake");
-    if (m_local) { doHandShakeLocal(Snds, Rcvs); }
-    else         { doHandShakeGlobal(Snds, Rcvs); }
+    if (m_local)      { doHandShakeLocal(Snds, Rcvs); }
+    else if (m_cache) { doHandShakeCached(Snds, Rcvs); }
+    else              { doHandShakeGlobal(Snds, Rcvs); }
+}
+
+void ParticleCopyPlan::doHandShakeCached (const Vector<Long>& Snds, Vector<Long>& Rcvs) const // NOLINT(readability-convert-member-functions-to-static)
+{
+#ifdef AMREX_USE_MPI
+    MPI_Comm comm = ParallelContext::CommunicatorSub();
+    const int NProcs = ParallelContext::NProcsSub();
+
+    // Does anyone need to send to a proc outside of its cached neighbors
+    // (2), or have neighbors that have been idle for too long (1)? Only a
+    // global operation can tell a proc that someone outside of its set has
+    // particles for it, so this cannot be done on the graph.
+    int action = 0;
+    if (! m_cache->isValid(comm)) {
+        action = 2;
+    } else {
+        for (int i = 0; i < NProcs; ++i) {
+            if (Snds[i] > 0 && ! m_cache->isNeighbor(i)) {
+                action = 2;
+                break;
+            }
+        }
+        if (action == 0 && m_cache->needsPrune()) { action = 1; }
+    }
+    BL_MPI_REQUIRE( MPI_Allreduce(MPI_IN_PLACE, &action, 1, MPI_INT, MPI_MAX, comm) );
+
+    if (action == 2)
+    {
+        doHandShakeGlobal(Snds, Rcvs);
+        m_cache->update(comm, Snds, Rcvs);
+        return;
+    }
+    else if (action == 1)
+    {
+        m_cache->prune(comm);
+    }
+
+    const auto& procs = m_cache->m_procs;
+    const auto n = static_cast<int>(procs.size());
+    Vector<Long> snd_counts(n);
+    Vector<Long> rcv_counts(n, 0);
+    for (int i = 0; i < n; ++i) {
+        snd_counts[i] = Snds[procs[i]];
+    }
+
+    BL_COMM_PROFILE(BLProfiler::Alltoall, sizeof(Long),
+                    ParallelContext::MyProcSub(), BLProfiler::BeforeCall());
+
+    BL_MPI_REQUIRE( MPI_Neighbor_alltoall(snd_counts.dataPtr(), 1,
+                                          ParallelDescriptor::Mpi_typemap<Long>::type(),
+                                          rcv_counts.dataPtr(), 1,
+                                          ParallelDescriptor::Mpi_typemap<Long>::type(),
+                                          m_cache->m_graph_comm) );
+
+    BL_COMM_PROFILE(BLProfiler::Alltoall, sizeof(Long),
+                    ParallelContext::MyProcSub(), BLProfiler::AfterCall());
+
+    for (int i = 0; i < n; ++i) {
+        Rcvs[procs[i]] = rcv_counts[i];
+    }
+
+    m_cache->recordCounts(Snds, Rcvs);
+#else
+    amrex::ignore_unused(Snds,Rcvs);
+#endif
 }
 
 void ParticleCopyPlan::doHandShakeLocal (const Vector<Long>& Snds, Vector<Long>& Rcvs) const // NOLINT(readability-convert-member-functions-to-static)
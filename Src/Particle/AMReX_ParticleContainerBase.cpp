@@ -11,6 +11,8 @@ bool    ParticleContainerBase::do_tiling = false;
 IntVect ParticleContainerBase::tile_size { AMREX_D_DECL(1024000,8,8) };
 bool    ParticleContainerBase::memEfficientSort = true;
 bool    ParticleContainerBase::use_comms_arena = false;
+bool    ParticleContainerBase::use_omp_redistribute = false;
+bool    ParticleContainerBase::use_persistent_copy_plan = false;
 
 void ParticleContainerBase::Define (const Geometry            & geom,
                                     const DistributionMapping & dmap,
@@ -77,6 +79,8 @@ ParticleContainerBase::defineBufferMap () const
     if (! m_buffer_map.isValid(GetParGDB()))
     {
         m_buffer_map.define(GetParGDB());
+        // the grids have changed, so the ranks we talk to probably have too
+        m_copy_plan_cache.clear();
     }
 }
 
@@ -0,0 +1,148 @@
+#include <AMReX_SpMV.H>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+
+using namespace amrex;
+
+namespace {
+
+// Each row couples to its neighbors, to itself and to the row half way
+// around, so that every rank needs remote elements of x.
+constexpr int num_non_zeros = 4;
+
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+Real mat_val (Long row, Long col, Real s)
+{
+    return s * (Real(1) + Real(row % 7) + Real(0.01)*Real(col % 13));
+}
+
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+Real x_val (Long col, int ix)
+{
+    return Real(1) + Real(0.1)*Real((col*(ix+3)) % 11);
+}
+
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+void stencil (Long row, Long n, Long* col)
+{
+    col[0] = (row == 0) ? n-1 : row-1;
+    col[1] = row;
+    col[2] = (row == n-1) ? 0 : row+1;
+    col[3] = (row + n/2) % n;
+}
+
+void make_matrix (SpMatrix<Real>& mat, Long n, Real s)
+{
+    mat.setVal([=] AMREX_GPU_DEVICE (Long row, Long* col, Real* val)
+    {
+        stencil(row, n, col);
+        for (int i = 0; i < num_non_zeros; ++i) {
+            val[i] = mat_val(row, col[i], s);
+        }
+    });
+}
+
+void fill_x (AlgVector<Real>& x, int ix)
+{
+    auto* p = x.data();
+    auto ib = x.globalBegin();
+    ParallelFor(x.numLocalRows(), [=] AMREX_GPU_DEVICE (Long lrow)
+    {
+        p[lrow] = x_val(lrow+ib, ix);
+    });
+}
+
+Real error (AlgVector<Real> const& y, Long n, Real s, int ix)
+{
+    AlgVector<Real> yex(y.partition());
+    auto* p = yex.data();
+    auto ib = yex.globalBegin();
+    ParallelFor(yex.numLocalRows(), [=] AMREX_GPU_DEVICE (Long lrow)
+    {
+        Long row = lrow + ib;
+        Long col[num_non_zeros];
+        stencil(row, n, col);
+        Real r = 0;
+        for (int i = 0; i < num_non_zeros; ++i) {
+            r += mat_val(row, col[i], s) * x_val(col[i], ix);
+        }
+        p[lrow] = r;
+    });
+    Axpy(yex, Real(-1.0), y);
+    return yex.norminf();
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        Long n = 4096;
+        int nrepeat = 100;
+        {
+            ParmParse pp;
+            pp.query("n", n);
+            pp.query("nrepeat", nrepeat);
+        }
+
+        auto eps = (sizeof(Real) == 4) ? Real(1.e-5) : Real(1.e-12);
+
+        AlgVector<Real> x(n);
+        AlgVector<Real> y(x.partition());
+        AlgVector<Real> y2(x.partition());
+
+        SpMatrix<Real> A(x.partition(), num_non_zeros);
+        make_matrix(A, n, Real(1));
+
+        SpMVPlan<Real> plan(A);
+
+        // Repeated applies with the same and with a different x.
+        for (int ix = 0; ix < 2; ++ix) {
+            fill_x(x, ix);
+            for (int i = 0; i < 3; ++i) {
+                y.setVal(Real(-1.0));
+                plan.apply(y, x);
+                auto err = error(y, n, Real(1), ix) / x.norminf();
+                amrex::Print() << "  SpMVPlan x" << ix << " apply " << i
+                               << " error: " << err << "\n";
+                AMREX_ALWAYS_ASSERT(err < eps);
+            }
+
+            SpMV(y2, A, x);
+            Axpy(y2, Real(-1.0), y);
+            amrex::Print() << "  SpMVPlan vs. SpMV difference: " << y2.norminf() << "\n";
+            AMREX_ALWAYS_ASSERT(y2.norminf() == Real(0));
+        }
+
+        // Switch the plan to another matrix.
+        SpMatrix<Real> B(x.partition(), num_non_zeros);
+        make_matrix(B, n, Real(-2));
+        plan.define(B);
+        plan.apply(y, x);
+        {
+            auto err = error(y, n, Real(-2), 1) / (Real(2)*x.norminf());
+            amrex::Print() << "  SpMVPlan with redefined matrix error: " << err << "\n";
+            AMREX_ALWAYS_ASSERT(err < eps);
+        }
+
+        // Timing of a reused plan vs. the SpMV function, which sets up a
+        // plan on every call.
+        Gpu::streamSynchronize();
+        auto t0 = amrex::second();
+        for (int i = 0; i < nrepeat; ++i) {
+            plan.apply(y, x);
+        }
+        Gpu::streamSynchronize();
+        auto t1 = amrex::second();
+        for (int i = 0; i < nrepeat; ++i) {
+            SpMV(y2, B, x);
+        }
+        Gpu::streamSynchronize();
+        auto t2 = amrex::second();
+        amrex::Print() << "  " << nrepeat << " products: SpMVPlan " << t1-t0
+                       << " s, SpMV " << t2-t1 << " s\n";
+    }
+    amrex::Finalize();
+}
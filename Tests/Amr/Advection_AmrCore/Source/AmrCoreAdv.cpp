@@ -104,9 +104,11 @@ AmrCoreAdv::Evolve ()
     int levmean = max_level;
     MultiFab mfmean;
     int test_fillpatchnlevels = 0;
+    int test_grids = 0;
     {
         ParmParse pp;
         pp.query("test_fillpatchnlevels", test_fillpatchnlevels);
+        pp.query("test_grids", test_grids);
     }
     if (test_fillpatchnlevels) {
         Box bxmean = geom[levmean].Domain();
@@ -134,6 +136,10 @@ AmrCoreAdv::Evolve ()
 
         cur_time += dt[0];
 
+        if (test_grids) {
+            CheckGrids();
+        }
+
         // sum phi to check conservation
         Real sum_phi = phi_new[0].sum();
 
@@ -185,6 +191,10 @@ AmrCoreAdv::Evolve ()
         }
     }
 
+    if (test_grids) {
+        amrex::Print() << "\nGrid test passed\n\n";
+    }
+
     if (test_fillpatchnlevels) {
         if (mfmean.is_finite()) {
             amrex::Print() << "\namrex::FillPatchNLevels test passed\n\n";
@@ -266,13 +276,14 @@ AmrCoreAdv::RemakeLevel (int lev, Real time, const BoxArray& ba,
     const int ncomp = phi_new[lev].nComp();
     const int ng = phi_new[lev].nGrow();
 
-    MultiFab new_state(ba, dm, ncomp, ng);
-    MultiFab old_state(ba, dm, ncomp, ng);
-
+    // Only the boxes not in the old grids on the same process are filled.
     // Must use fillpatch_function
-    FillPatch(lev, time, new_state, 0, ncomp, FillPatchType::fillpatch_function);
+    RemakeFabArray(phi_new[lev], ba, dm, [&] (MultiFab& new_state)
+    {
+        FillPatch(lev, time, new_state, 0, ncomp, FillPatchType::fillpatch_function);
+    });
 
-    std::swap(new_state, phi_new[lev]);
+    MultiFab old_state(ba, dm, ncomp, ng);
     std::swap(old_state, phi_old[lev]);
 
     t_new[lev] = time;
@@ -425,6 +436,7 @@ AmrCoreAdv::ReadParameters ()
         pp.query("cfl", cfl);
         pp.query("do_reflux", do_reflux);
         pp.query("do_subcycle", do_subcycle);
+        pp.query("do_load_balance", do_load_balance);
     }
 
 #ifdef AMREX_PARTICLES
@@ -624,6 +636,9 @@ AmrCoreAdv::timeStepWithSubcycling (int lev, Real time, int iteration)
                 // regrid could add newly refine levels (if finest_level < max_level)
                 // so we save the previous finest level index
                 int old_finest = finest_level;
+                if (lev == 0 && do_load_balance) {
+                    LoadBalance(0, time);
+                }
                 regrid(lev, time);
 
                 // mark that we have regridded this level already
@@ -658,9 +673,17 @@ AmrCoreAdv::timeStepWithSubcycling (int lev, Real time, int iteration)
 
     Real t_nph = t_old[lev] + 0.5*dt[lev];
 
+    if (do_load_balance) {
+        GetLoadBalancer(lev).startTiming();
+    }
+
     DefineVelocityAtLevel(lev, t_nph);
     AdvancePhiAtLevel(lev, time, dt[lev], iteration, nsubsteps[lev]);
 
+    if (do_load_balance) {
+        GetLoadBalancer(lev).stopTiming();
+    }
+
 
 #ifdef AMREX_PARTICLES
     if (do_tracers) {
@@ -774,6 +797,45 @@ AmrCoreAdv::timeStepNoSubcycling (Real time, int iteration)
     }
 }
 
+// abort unless the grids are disjoint, aligned with the blocking factor
+// and properly nested
+void
+AmrCoreAdv::CheckGrids () const
+{
+    for (int lev = 1; lev <= finest_level; ++lev)
+    {
+        const BoxArray& ba = boxArray(lev);
+        if (!ba.isDisjoint()) {
+            amrex::Abort("Grid test failed: level " + std::to_string(lev) + " grids overlap");
+        }
+        if (!ba.coarsenable(blockingFactor(lev))) {
+            amrex::Abort("Grid test failed: level " + std::to_string(lev)
+                         + " grids are not aligned with the blocking factor");
+        }
+
+        // The coarsened fine grids grown by n_proper cells must be covered
+        // by the coarse grids, except outside non-periodic boundaries.
+        const Geometry& cgeom = Geom(lev-1);
+        const Box& cdomain = cgeom.Domain();
+        const BoxArray& cba = boxArray(lev-1);
+        Vector<IntVect> pshifts;
+        for (int i = 0, N = static_cast<int>(ba.size()); i < N; ++i)
+        {
+            Box b = amrex::coarsen(ba[i], refRatio(lev-1));
+            b.grow(nProper());
+            bool nested = cba.contains(b & cdomain);
+            cgeom.periodicShift(cdomain, b, pshifts);
+            for (auto const& iv : pshifts) {
+                nested = nested && cba.contains((b+iv) & cdomain);
+            }
+            if (!nested) {
+                amrex::Abort("Grid test failed: level " + std::to_string(lev)
+                             + " grids are not properly nested");
+            }
+        }
+    }
+}
+
 // a wrapper for EstTimeStep
 void
 AmrCoreAdv::ComputeDt ()
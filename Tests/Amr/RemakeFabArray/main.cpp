@@ -0,0 +1,145 @@
+#include <AMReX.H>
+#include <AMReX_FillPatchUtil.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+
+#include <map>
+
+using namespace amrex;
+
+namespace {
+
+void fill_valid (MultiFab& mf)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        ParallelFor(mfi.validbox(), mf.nComp(), [=] AMREX_GPU_DEVICE (int i, int j, int k, int n)
+        {
+            a(i,j,k,n) = Real(i) + Real(100*j) + Real(10000*k) + Real(1000000*n);
+        });
+    }
+}
+
+Long local_bytes (MultiFab const& mf)
+{
+    Long nbytes = 0;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        nbytes += mf[mfi].nBytesOwned();
+    }
+    return nbytes;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 16;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+        }
+
+        const int nprocs = ParallelDescriptor::NProcs();
+
+        Box domain(IntVect(0), IntVect(n_cell-1));
+        BoxArray old_ba(domain);
+        old_ba.maxSize(max_grid_size);
+        DistributionMapping old_dm(old_ba);
+
+        // A non-default arena, so that we can check where the new FABs are.
+        Arena* ar = The_Pinned_Arena();
+        const int ncomp = 2;
+        MultiFab mf(old_ba, old_dm, ncomp, 1, MFInfo().SetArena(ar));
+        mf.setVal(Real(-1.0));
+        fill_valid(mf);
+
+        // Split every fourth box in two and keep the others on their
+        // processes.
+        BoxList bl;
+        Vector<int> pmap;
+        for (int i = 0, N = static_cast<int>(old_ba.size()); i < N; ++i) {
+            const Box& bx = old_ba[i];
+            if (i % 4 == 3) {
+                Box lo = bx;
+                Box hi = lo.chop(0, bx.smallEnd(0) + bx.length(0)/2);
+                bl.push_back(lo);
+                bl.push_back(hi);
+                pmap.push_back(i % nprocs);
+                pmap.push_back((i+1) % nprocs);
+            } else {
+                bl.push_back(bx);
+                pmap.push_back(old_dm[i]);
+            }
+        }
+        BoxArray new_ba(std::move(bl));
+        DistributionMapping new_dm(std::move(pmap));
+
+        std::map<Box,std::pair<FArrayBox const*,Real const*>> old_fabs;
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            old_fabs[mfi.validbox()] = {mf.fabPtr(mfi), mf[mfi].dataPtr()};
+        }
+
+        const Long old_bytes = local_bytes(mf);
+        const Long old_usage = FabArrayBase::queryMemUsage("All");
+
+        int nfilled = 0;
+        RemakeFabArray(mf, new_ba, new_dm, [&] (MultiFab& dst)
+        {
+            for (MFIter mfi(dst); mfi.isValid(); ++mfi) { ++nfilled; }
+            dst.setVal(Real(-1.0));
+            fill_valid(dst);
+        });
+
+        AMREX_ALWAYS_ASSERT(mf.boxArray() == new_ba && mf.DistributionMap() == new_dm);
+
+        // The memory usage counts the new FABs.
+        const Long dusage = FabArrayBase::queryMemUsage("All") - old_usage;
+        const Long dbytes = local_bytes(mf) - old_bytes;
+
+        // The FABs of the boxes kept are the old ones, including the
+        // ghost cells. The others have been filled.
+        int nkept = 0;
+        int nbad = 0;
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            auto const& fab = mf[mfi];
+            nbad += (fab.arena() != ar);
+            auto it = old_fabs.find(mfi.validbox());
+            if (it != old_fabs.end()) {
+                ++nkept;
+                nbad += (mf.fabPtr(mfi) != it->second.first)
+                    +   (fab.dataPtr() != it->second.second);
+                for (int n = 0; n < ncomp; ++n) {
+                    nbad += (fab.min<RunOn::Device>(mfi.fabbox(), n) != Real(-1.0));
+                }
+            }
+        }
+        AMREX_ALWAYS_ASSERT(nkept + nfilled == mf.local_size());
+        ParallelDescriptor::ReduceIntSum(nkept);
+        ParallelDescriptor::ReduceIntSum(nbad);
+
+        MultiFab ref(new_ba, new_dm, ncomp, 0);
+        const Long ref_bytes = local_bytes(ref);
+        fill_valid(ref);
+        MultiFab::Subtract(ref, mf, 0, 0, ncomp, 0);
+        const Real diff = ref.norminf(0, ncomp, IntVect(0));
+
+        amrex::Print() << "  " << nkept << " of " << new_ba.size()
+                       << " boxes kept, " << nbad << " errors, data difference "
+                       << diff << "\n";
+        AMREX_ALWAYS_ASSERT(nkept == static_cast<int>(old_ba.size() - old_ba.size()/4));
+        AMREX_ALWAYS_ASSERT(nbad == 0 && diff == Real(0));
+        AMREX_ALWAYS_ASSERT(dusage == dbytes);
+
+        // Clearing the MultiFab gives back all of its bytes.
+        const Long new_bytes = local_bytes(mf);
+        const Long new_usage = FabArrayBase::queryMemUsage("All");
+        ref.clear();
+        mf.clear();
+        AMREX_ALWAYS_ASSERT(new_usage - FabArrayBase::queryMemUsage("All") == new_bytes + ref_bytes);
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,159 @@
+#include <AMReX.H>
+#include <AMReX_AsyncOut.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Random.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VisMF.H>
+
+#include <cstring>
+#include <fstream>
+#include <string>
+
+using namespace amrex;
+
+namespace {
+
+constexpr int ncomp = 3;
+constexpr int nghost = 2;
+
+void init (MultiFab& mf)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), ncomp, [&] (int i, int j, int k, int n)
+        {
+            a(i,j,k,n) = amrex::Random();
+        });
+    }
+}
+
+// The data read back must be bit-identical on box, which is the valid box
+// grown by ng.
+void check (MultiFab const& mf, MultiFab const& mf2, int ng)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.growntilebox(ng);
+        auto const& a = mf.const_array(mfi);
+        auto const& b = mf2.const_array(mfi);
+        amrex::LoopOnCpu(bx, ncomp, [&] (int i, int j, int k, int n)
+        {
+            AMREX_ALWAYS_ASSERT(std::memcmp(&a(i,j,k,n), &b(i,j,k,n), sizeof(Real)) == 0);
+        });
+    }
+}
+
+// The total size of the data files of a MultiFab. There are at most as
+// many files as processes, but some numbers may be missing.
+Long file_bytes (std::string const& name)
+{
+    Long r = 0;
+    for (int i = 0; i < ParallelDescriptor::NProcs(); ++i) {
+        std::ifstream ifs(amrex::Concatenate(name + "_D_", i, 5),
+                          std::ios::binary | std::ios::ate);
+        if (ifs.good()) {
+            r += static_cast<Long>(ifs.tellg());
+        }
+    }
+    return r;
+}
+
+MultiFab read (MultiFab const& mf, std::string const& name, int ng)
+{
+    AsyncOut::Finish();
+    ParallelDescriptor::Barrier();
+    AMREX_ALWAYS_ASSERT(VisMF::Check(name));
+    MultiFab mf2(mf.boxArray(), mf.DistributionMap(), ncomp, ng);
+    VisMF::Read(mf2, name);
+    return mf2;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 16;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+        }
+        AMREX_ALWAYS_ASSERT(AsyncOut::UseAsyncOut());
+
+        BoxArray ba(Box(IntVect(0), IntVect(n_cell-1)));
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        MultiFab mf(ba, dm, ncomp, nghost);
+
+        amrex::UtilCreateDirectoryDestructive("asyncout");
+
+        amrex::Print() << "Testing AsyncWrite with ghost cells\n";
+        {
+            init(mf);
+            VisMF::AsyncWrite(mf, "asyncout/a");
+            check(mf, read(mf, "asyncout/a", nghost), nghost);
+        }
+
+        amrex::Print() << "Testing a shorter file written over one still being written\n";
+        {
+            init(mf);
+            VisMF::AsyncWrite(mf, "asyncout/b");
+            // The data are copied before AsyncWrite returns.
+            mf.setVal(-1.0);
+
+            // The second MultiFab is small, so that it is written while the
+            // first one is still in flight, and stale data of the first one
+            // past its end would show up.
+            BoxArray ba2(Box(IntVect(0), IntVect(7)));
+            DistributionMapping dm2(ba2);
+            MultiFab mf2(ba2, dm2, ncomp, nghost);
+            init(mf2);
+            VisMF::AsyncWrite(mf2, "asyncout/b", true);
+            check(mf2, read(mf2, "asyncout/b", 0), 0);
+
+            MultiFab mf0(ba2, dm2, ncomp, 0);
+            MultiFab::Copy(mf0, mf2, 0, 0, ncomp, 0);
+            VisMF::Write(mf0, "asyncout/b_ref");
+            ParallelDescriptor::Barrier();
+            if (ParallelDescriptor::IOProcessor()) {
+                AMREX_ALWAYS_ASSERT(file_bytes("asyncout/b") == file_bytes("asyncout/b_ref"));
+            }
+        }
+
+        amrex::Print() << "Testing AsyncWrite of an rvalue\n";
+        {
+            init(mf);
+            MultiFab mf1(ba, dm, ncomp, nghost);
+            MultiFab::Copy(mf1, mf, 0, 0, ncomp, nghost);
+            VisMF::AsyncWrite(std::move(mf1), "asyncout/c");
+            check(mf, read(mf, "asyncout/c", nghost), nghost);
+        }
+
+        amrex::Print() << "Comparing write times\n";
+        {
+            init(mf);
+            ParallelDescriptor::Barrier();
+            auto t0 = amrex::second();
+            VisMF::Write(mf, "asyncout/d");
+            ParallelDescriptor::Barrier();
+            auto t1 = amrex::second();
+            VisMF::AsyncWrite(mf, "asyncout/e");
+            ParallelDescriptor::Barrier();
+            auto t2 = amrex::second();
+            AsyncOut::Finish();
+            ParallelDescriptor::Barrier();
+            auto t3 = amrex::second();
+            amrex::Print() << "  VisMF::Write: " << t1-t0 << " s, AsyncWrite returned after "
+                           << t2-t1 << " s and finished after " << t3-t1 << " s\n";
+            check(mf, read(mf, "asyncout/e", nghost), nghost);
+        }
+
+        amrex::Print() << "All AsyncWrite tests passed\n";
+    }
+    amrex::Finalize();
+}
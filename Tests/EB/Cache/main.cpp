@@ -0,0 +1,127 @@
+#include <AMReX.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_FileSystem.H>
+#include <AMReX_ParmParse.H>
+
+#include <cstring>
+#include <filesystem>
+
+using namespace amrex;
+
+namespace {
+
+struct EBFracs
+{
+    MultiFab volfrac;
+    MultiFab centroid;
+    Array<MultiFab,AMREX_SPACEDIM> areafrac;
+};
+
+EBFracs build_eb (Geometry const& geom, BoxArray const& ba, DistributionMapping const& dm)
+{
+    EB2::Build(geom, 0, 2);
+
+    EBFracs r;
+    {
+        auto factory = makeEBFabFactory(geom, ba, dm, {1,1,1}, EBSupport::full);
+        r.volfrac.define(ba, dm, 1, 1);
+        MultiFab::Copy(r.volfrac, factory->getVolFrac(), 0, 0, 1, 1);
+        r.centroid = factory->getCentroid().ToMultiFab(0.0, 0.0);
+        auto areafrac = factory->getAreaFrac();
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            r.areafrac[idim] = areafrac[idim]->ToMultiFab(1.0, 0.0);
+        }
+    }
+    EB2::IndexSpace::pop();
+    return r;
+}
+
+Long count_diff (MultiFab const& a, MultiFab const& b)
+{
+    Long ndiff = 0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi) {
+        auto const& fa = a[mfi];
+        auto const& fb = b[mfi];
+        AMREX_ALWAYS_ASSERT(fa.box() == fb.box());
+        ndiff += (std::memcmp(fa.dataPtr(), fb.dataPtr(), fa.nBytes()) != 0);
+    }
+    ParallelDescriptor::ReduceLongSum(ndiff);
+    return ndiff;
+}
+
+Long count_diff (EBFracs const& a, EBFracs const& b)
+{
+    Long ndiff = count_diff(a.volfrac, b.volfrac) + count_diff(a.centroid, b.centroid);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        ndiff += count_diff(a.areafrac[idim], b.areafrac[idim]);
+    }
+    return ndiff;
+}
+
+// The number of entries in the cache directory
+int num_entries (std::string const& dir)
+{
+    int n = 0;
+    if (ParallelDescriptor::IOProcessor()) {
+        for (auto const& entry : std::filesystem::directory_iterator(dir)) {
+            amrex::ignore_unused(entry);
+            ++n;
+        }
+    }
+    ParallelDescriptor::Bcast(&n, 1, ParallelDescriptor::IOProcessorNumber());
+    return n;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        Box domain(IntVect(0), IntVect(63));
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Geometry geom(domain, rb, CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+        BoxArray ba(domain);
+        ba.maxSize(16);
+        DistributionMapping dm(ba);
+
+        const std::string cache_dir("eb_cache");
+        if (ParallelDescriptor::IOProcessor()) {
+            FileSystem::RemoveAll(cache_dir);
+            FileSystem::CreateDirectories(cache_dir, 0755);
+        }
+        ParallelDescriptor::Barrier();
+
+        ParmParse pp("eb2");
+        pp.add("geom_type", std::string("sphere"));
+        pp.addarr("sphere_center", std::vector<Real>{AMREX_D_DECL(Real(0.5),Real(0.45),Real(0.52))});
+        pp.add("sphere_radius", Real(0.3));
+        pp.add("sphere_has_fluid_inside", false);
+
+        const EBFracs fresh = build_eb(geom, ba, dm);
+        AMREX_ALWAYS_ASSERT(num_entries(cache_dir) == 0);
+
+        pp.add("cache_dir", cache_dir);
+
+        // The first build writes the cache, and the second reads it.
+        for (int i = 0; i < 2; ++i) {
+            const EBFracs cached = build_eb(geom, ba, dm);
+            const Long ndiff = count_diff(cached, fresh);
+            amrex::Print() << "  build " << i << " with eb2.cache_dir: " << ndiff
+                           << " FABs differ\n";
+            AMREX_ALWAYS_ASSERT(ndiff == 0);
+            AMREX_ALWAYS_ASSERT(num_entries(cache_dir) == 1);
+        }
+
+        // Another geometry gets its own entry.
+        pp.remove("sphere_radius");
+        pp.add("sphere_radius", Real(0.25));
+        const EBFracs other = build_eb(geom, ba, dm);
+        AMREX_ALWAYS_ASSERT(count_diff(other, fresh) > 0);
+        AMREX_ALWAYS_ASSERT(num_entries(cache_dir) == 2);
+
+        amrex::Print() << "All EB cache tests passed\n";
+    }
+    amrex::Finalize();
+}
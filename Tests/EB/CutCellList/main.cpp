@@ -0,0 +1,172 @@
+#include <AMReX.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_EBMultiFabUtil.H>
+#include <AMReX_MultiCutCellList.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Reduce.H>
+
+#include <type_traits>
+
+using namespace amrex;
+
+static_assert(!std::is_copy_constructible_v<MultiCutCellList> &&
+              !std::is_copy_assignable_v<MultiCutCellList>);
+static_assert(std::is_nothrow_move_constructible_v<MultiCutCellList>);
+
+namespace {
+
+// Number of mismatches between the list and the flags and data of the factory
+Long check_list (MultiCutCellList const& cutcells, EBFArrayBoxFactory const& factory)
+{
+    auto const& flags = factory.getMultiEBCellFlagFab();
+    auto const& vfrac = factory.getVolFrac();
+    auto const& cent = factory.getCentroid();
+    auto const& barea = factory.getBndryArea();
+    AMREX_ALWAYS_ASSERT(cutcells.local_size() == flags.local_size());
+
+    Long nbad = 0;
+    for (MFIter mfi(flags); mfi.isValid(); ++mfi)
+    {
+        auto const& cl = cutcells.const_list(mfi);
+        const Box& bx = amrex::grow(mfi.validbox(), cutcells.nGrow());
+        AMREX_ALWAYS_ASSERT(cl.m_box == bx);
+
+        // Every cell of the box is in the list if and only if it is cut.
+        auto const& flag = flags.const_array(mfi);
+        const auto npts = static_cast<int>(bx.numPts());
+        const int ncut = Reduce::Sum<int>(npts, [=] AMREX_GPU_DEVICE (int i) noexcept -> int
+        {
+            return flag(bx.atOffset(i)).isSingleValued() ? 1 : 0;
+        });
+        const int nfind = Reduce::Sum<int>(npts, [=] AMREX_GPU_DEVICE (int i) noexcept -> int
+        {
+            IntVect iv = bx.atOffset(i);
+            auto c = iv.dim3();
+            int m = cl.find(c.x, c.y, c.z);
+            bool cut = flag(iv).isSingleValued();
+            if (cut) {
+                return (m >= 0 && cl.cell(m) == iv) ? 0 : 1;
+            } else {
+                return (m == -1) ? 0 : 1;
+            }
+        });
+        nbad += (ncut != cl.size()) + nfind;
+
+        // Outside the box
+        const Box& gbx = amrex::grow(bx,1);
+        auto c = gbx.bigEnd().dim3();
+        nbad += (cl.find(c.x, c.y, c.z) != -1);
+
+        // The data of each cut cell match the factory.
+        if (cl.size() > 0) {
+            auto const& vf = vfrac.const_array(mfi);
+            auto const& ct = cent.const_array(mfi);
+            auto const& ba = barea.const_array(mfi);
+            nbad += Reduce::Sum<int>(cl.size(), [=] AMREX_GPU_DEVICE (int m) noexcept -> int
+            {
+                IntVect const& iv = cl.cell(m);
+                int r = (cl.get<EBData_t::volfrac>(m) != vf(iv))
+                    +   (cl.get<EBData_t::bndryarea>(m) != ba(iv));
+                for (int n = 0; n < AMREX_SPACEDIM; ++n) {
+                    r += (cl.get<EBData_t::centroid>(m,n) != ct(iv,n));
+                }
+                return r;
+            });
+        }
+    }
+    ParallelDescriptor::ReduceLongSum(nbad);
+    return nbad;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 16;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+        }
+
+        Box domain(IntVect(0), IntVect(n_cell-1));
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Geometry geom(domain, rb, CoordSys::cartesian, {AMREX_D_DECL(1,1,1)});
+
+        EB2::SphereIF sphere(0.3, {AMREX_D_DECL(0.5,0.5,0.5)}, false);
+        EB2::Build(EB2::makeShop(sphere), geom, 0, 0);
+
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        const int ngrow = 2;
+        auto full = makeEBFabFactory(geom, ba, dm, {ngrow,ngrow,ngrow}, EBSupport::full);
+        auto basic = makeEBFabFactory(geom, ba, dm, {ngrow,ngrow,ngrow}, EBSupport::basic);
+
+        // The lists from the factory data and from the EB2::Level must both
+        // match the factory.
+        for (int ng : {0, ngrow}) {
+            MultiCutCellList from_full(*full, ng);
+            MultiCutCellList from_level(*basic, ng);
+            auto nbad_full = check_list(from_full, *full);
+            auto nbad_level = check_list(from_level, *full);
+            amrex::Print() << "  ngrow " << ng << ": " << from_full.numCutCells()
+                           << " cut cells on rank 0, mismatches " << nbad_full
+                           << " (full factory), " << nbad_level << " (basic factory)\n";
+            AMREX_ALWAYS_ASSERT(nbad_full == 0 && nbad_level == 0);
+        }
+
+        // The views stay valid after a move.
+        MultiCutCellList cutcells;
+        {
+            MultiCutCellList tmp(*basic);
+            cutcells = std::move(tmp);
+        }
+        AMREX_ALWAYS_ASSERT(check_list(cutcells, *full) == 0);
+
+        // EB_interp_CC_to_Centroid with a basic factory and the list vs.
+        // with a full factory.
+        const int ncomp = 2;
+        MultiFab cc_full(ba, dm, ncomp, 1, MFInfo(), *full);
+        MultiFab cc_basic(ba, dm, ncomp, 1, MFInfo(), *basic);
+        MultiFab cent_full(ba, dm, ncomp, 1, MFInfo(), *full);
+        MultiFab cent_basic(ba, dm, ncomp, 1, MFInfo(), *basic);
+        cent_full.setVal(0.0);
+        cent_basic.setVal(0.0);
+        auto const dx = geom.CellSizeArray();
+        for (MFIter mfi(cc_full); mfi.isValid(); ++mfi) {
+            auto const& a = cc_full.array(mfi);
+            auto const& b = cc_basic.array(mfi);
+            ParallelFor(mfi.fabbox(), ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n)
+            {
+                Real x = (i+Real(0.5))*dx[0];
+                Real y = (j+Real(0.5))*dx[1];
+                a(i,j,k,n) = b(i,j,k,n) = std::sin(Real(2+n)*x) * std::cos(Real(3)*y)
+                    + Real(k)*Real(0.01);
+            });
+        }
+
+        Gpu::streamSynchronize();
+        auto t0 = amrex::second();
+        EB_interp_CC_to_Centroid(cent_full, cc_full, 0, 0, ncomp, geom);
+        Gpu::streamSynchronize();
+        auto t1 = amrex::second();
+        EB_interp_CC_to_Centroid(cent_basic, cc_basic, 0, 0, ncomp, geom, cutcells);
+        Gpu::streamSynchronize();
+        auto t2 = amrex::second();
+
+        MultiFab::Subtract(cent_basic, cent_full, 0, 0, ncomp, 1);
+        auto diff = cent_basic.norminf(0, ncomp, IntVect(1));
+        amrex::Print() << "  EB_interp_CC_to_Centroid difference: " << diff
+                       << ", time " << t1-t0 << " s (MultiCutFab), "
+                       << t2-t1 << " s (MultiCutCellList)\n";
+        AMREX_ALWAYS_ASSERT(diff == Real(0));
+    }
+    amrex::Finalize();
+}
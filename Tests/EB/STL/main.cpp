@@ -0,0 +1,263 @@
+#include <AMReX.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_EB_STL_utils.H>
+#include <AMReX_Math.H>
+#include <AMReX_ParmParse.H>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+using namespace amrex;
+
+namespace {
+
+using STLTriangle = std::array<float,9>;
+
+// An ellipsoid made of a subdivided icosahedron
+Vector<STLTriangle> make_ellipsoid (int nrefine)
+{
+    const double t = (1.0 + std::sqrt(5.0)) / 2.0;
+    using V = std::array<double,3>;
+    Vector<V> v{{-1, t, 0}, { 1, t, 0}, {-1,-t, 0}, { 1,-t, 0},
+                { 0,-1, t}, { 0, 1, t}, { 0,-1,-t}, { 0, 1,-t},
+                { t, 0,-1}, { t, 0, 1}, {-t, 0,-1}, {-t, 0, 1}};
+    auto normalize = [] (V const& a) -> V
+    {
+        double r = std::sqrt(a[0]*a[0] + a[1]*a[1] + a[2]*a[2]);
+        return {a[0]/r, a[1]/r, a[2]/r};
+    };
+    auto mid = [&] (V const& a, V const& b) -> V
+    {
+        return normalize({a[0]+b[0], a[1]+b[1], a[2]+b[2]});
+    };
+    Vector<std::array<V,3>> tris;
+    constexpr int faces[20][3] = {{0,11,5}, {0,5,1}, {0,1,7}, {0,7,10}, {0,10,11},
+                                  {1,5,9}, {5,11,4}, {11,10,2}, {10,7,6}, {7,1,8},
+                                  {3,9,4}, {3,4,2}, {3,2,6}, {3,6,8}, {3,8,9},
+                                  {4,9,5}, {2,4,11}, {6,2,10}, {8,6,7}, {9,8,1}};
+    for (auto const& f : faces) {
+        tris.push_back({normalize(v[f[0]]), normalize(v[f[1]]), normalize(v[f[2]])});
+    }
+    for (int iref = 0; iref < nrefine; ++iref) {
+        Vector<std::array<V,3>> fine;
+        for (auto const& [a, b, c] : tris) {
+            V ab = mid(a,b), bc = mid(b,c), ca = mid(c,a);
+            fine.push_back({a, ab, ca});
+            fine.push_back({b, bc, ab});
+            fine.push_back({c, ca, bc});
+            fine.push_back({ab, bc, ca});
+        }
+        std::swap(tris, fine);
+    }
+
+    const V center{0.5, 0.5, 0.5};
+    const V axes{0.35, 0.28, 0.22};
+    Vector<STLTriangle> r;
+    r.reserve(tris.size());
+    for (auto const& tri : tris) {
+        STLTriangle st;
+        for (int iv = 0; iv < 3; ++iv) {
+            for (int d = 0; d < 3; ++d) {
+                st[3*iv+d] = static_cast<float>(center[d] + axes[d]*tri[iv][d]);
+            }
+        }
+        r.push_back(st);
+    }
+    return r;
+}
+
+// The binary format is little endian.
+void write_binary_stl (std::string const& name, Vector<STLTriangle> const& tris)
+{
+    std::ofstream ofs(name, std::ios::binary);
+    char header[80] = "binary STL for Tests/EB/STL";
+    ofs.write(header, 80);
+    auto ntri = static_cast<std::uint32_t>(tris.size());
+    ofs.write(reinterpret_cast<char const*>(&ntri), 4);
+    for (auto const& tri : tris) {
+        float normal[3] = {0.f, 0.f, 0.f};
+        std::uint16_t attr = 0;
+        ofs.write(reinterpret_cast<char const*>(normal), 12);
+        ofs.write(reinterpret_cast<char const*>(tri.data()), 36);
+        ofs.write(reinterpret_cast<char const*>(&attr), 2);
+    }
+}
+
+// The vertices are printed exactly.
+void write_ascii_stl (std::string const& name, Vector<STLTriangle> const& tris)
+{
+    std::ofstream ofs(name);
+    ofs << std::setprecision(17);
+    ofs << "solid ellipsoid\n";
+    for (auto const& tri : tris) {
+        ofs << "facet normal 0 0 0\n"
+            << "outer loop\n";
+        for (int iv = 0; iv < 3; ++iv) {
+            ofs << "vertex " << double(tri[3*iv]) << " " << double(tri[3*iv+1])
+                << " " << double(tri[3*iv+2]) << "\n";
+        }
+        ofs << "endloop\n"
+            << "endfacet\n";
+    }
+    ofs << "endsolid ellipsoid\n";
+}
+
+struct EBFracs
+{
+    MultiFab volfrac;
+    Array<MultiFab,AMREX_SPACEDIM> areafrac;
+};
+
+EBFracs build_eb (std::string const& stl_file, bool use_bvh, Geometry const& geom,
+                 BoxArray const& ba, DistributionMapping const& dm)
+{
+    ParmParse pp("eb2");
+    pp.add("geom_type", std::string("stl"));
+    pp.add("stl_file", stl_file);
+    pp.add("stl_use_bvh", use_bvh);
+    EB2::Build(geom, 0, 0);
+
+    EBFracs r;
+    {
+        auto factory = makeEBFabFactory(geom, ba, dm, {1,1,1}, EBSupport::full);
+        r.volfrac.define(ba, dm, 1, 1);
+        MultiFab::Copy(r.volfrac, factory->getVolFrac(), 0, 0, 1, 1);
+        auto areafrac = factory->getAreaFrac();
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            r.areafrac[idim] = areafrac[idim]->ToMultiFab(1.0, 0.0);
+        }
+    }
+    EB2::IndexSpace::pop();
+    return r;
+}
+
+Long count_diff (MultiFab const& a, MultiFab const& b)
+{
+    Long ndiff = 0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi) {
+        auto const& fa = a[mfi];
+        auto const& fb = b[mfi];
+        AMREX_ALWAYS_ASSERT(fa.box() == fb.box());
+        ndiff += (std::memcmp(fa.dataPtr(), fb.dataPtr(), fa.nBytes()) != 0);
+    }
+    ParallelDescriptor::ReduceLongSum(ndiff);
+    return ndiff;
+}
+
+Long count_diff (EBFracs const& a, EBFracs const& b)
+{
+    Long ndiff = count_diff(a.volfrac, b.volfrac);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        ndiff += count_diff(a.areafrac[idim], b.areafrac[idim]);
+    }
+    return ndiff;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 48;
+        int max_grid_size = 16;
+        int nrefine = 4;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("nrefine", nrefine);
+        }
+
+        Box domain(IntVect(0), IntVect(n_cell-1));
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Geometry geom(domain, rb, CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        const std::string binary_file("ellipsoid.stl");
+        const std::string ascii_file("ellipsoid_ascii.stl");
+        auto const tris = make_ellipsoid(nrefine);
+        if (ParallelDescriptor::IOProcessor()) {
+            write_binary_stl(binary_file, tris);
+            write_ascii_stl(ascii_file, tris);
+        }
+        ParallelDescriptor::Barrier();
+        amrex::Print() << "  " << tris.size() << " triangles\n";
+
+        // The triangles and the BVH read by all the processes must be the
+        // same as when they are read by each process on its own.
+        {
+            BoxArray nba = amrex::convert(ba, IndexType::TheNodeType());
+            MultiFab all_ls(nba, dm, 1, 0);
+            MultiFab solo_ls(nba, dm, 1, 0);
+            for (bool use_bvh : {true, false}) {
+                STLtools all;
+                all.setBVHOptimization(use_bvh);
+                all.read_stl_file(binary_file, 1.0, {0.0,0.0,0.0}, 0);
+                all.fill(all_ls, IntVect(0), geom);
+
+#ifdef AMREX_USE_MPI
+                MPI_Comm self_comm;
+                MPI_Comm_split(ParallelDescriptor::Communicator(),
+                               ParallelDescriptor::MyProc(), 0, &self_comm);
+#endif
+                {
+#ifdef AMREX_USE_MPI
+                    ParallelContext::push(self_comm);
+#endif
+                    STLtools solo;
+                    solo.setBVHOptimization(use_bvh);
+                    solo.read_stl_file(binary_file, 1.0, {0.0,0.0,0.0}, 0);
+#ifdef AMREX_USE_MPI
+                    ParallelContext::pop();
+#endif
+                    solo.fill(solo_ls, IntVect(0), geom);
+
+                    int nbad = 0;
+                    for (MFIter mfi(all_ls); mfi.isValid(); ++mfi) {
+                        const Box& bx = mfi.validbox();
+                        nbad += (all.getBoxType(bx, geom, RunOn::Host)
+                                 != solo.getBoxType(bx, geom, RunOn::Host));
+                    }
+                    ParallelDescriptor::ReduceIntSum(nbad);
+                    const Long ndiff = count_diff(all_ls, solo_ls);
+                    amrex::Print() << "  use_bvh " << use_bvh << ": " << ndiff
+                                   << " FABs of the level set and " << nbad
+                                   << " box types differ between "
+                                   << ParallelDescriptor::NProcs() << " processes and 1\n";
+                    AMREX_ALWAYS_ASSERT(ndiff == 0 && nbad == 0);
+                }
+#ifdef AMREX_USE_MPI
+                MPI_Comm_free(&self_comm);
+#endif
+            }
+        }
+
+        // The EB data do not depend on how the file is read. The BVH visits
+        // the triangles in another order, so it is only compared with itself.
+        for (bool use_bvh : {true, false}) {
+            EBFracs ascii = build_eb(ascii_file, use_bvh, geom, ba, dm);
+            EBFracs binary = build_eb(binary_file, use_bvh, geom, ba, dm);
+            const Long ndiff = count_diff(binary, ascii);
+            amrex::Print() << "  use_bvh " << use_bvh << ": " << ndiff
+                           << " FABs differ between the binary and ascii files\n";
+            AMREX_ALWAYS_ASSERT(ndiff == 0);
+
+            // The fluid is outside, and the volume of the rest of the unit
+            // domain is close to that of the ellipsoid.
+            const auto dx = geom.CellSizeArray();
+            const Real vol = Real(1.0) - ascii.volfrac.sum(0) * AMREX_D_TERM(dx[0],*dx[1],*dx[2]);
+            const Real exact = Real(4./3.)*Math::pi<Real>()*Real(0.35*0.28*0.22);
+            amrex::Print() << "  volume " << vol << ", ellipsoid " << exact << "\n";
+            AMREX_ALWAYS_ASSERT(std::abs(vol-exact) < Real(0.01)*exact);
+        }
+    }
+    amrex::Finalize();
+}
@@ -1,4 +1,5 @@
 #include <AMReX_Utility.H>
+#include <AMReX_Machine.H>
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_MultiFab.H>
 #include <AMReX_ParmParse.H>
@@ -154,10 +155,37 @@ main (int argc, char* argv[])
     ParallelDescriptor::Barrier();
     auto wt1 = ParallelDescriptor::second();
 
+    // Number of ghost cells received from other nodes in one FillBoundary per level
+    Long inter_node_cells = 0;
+    {
+        int node_size = 0;
+        ParmParse pp("DistributionMapping");
+        pp.query("node_size", node_size);
+        const auto& node_of_rank = Machine::nodeOfRank();
+        auto node = [&] (int rank) {
+            return (node_size > 0) ? rank/node_size : node_of_rank[rank];
+        };
+        const int mynode = node(ParallelDescriptor::MyProc());
+        for (int lev = 0; lev < nlevels; ++lev) {
+            const auto& fb = mfs[lev]->getFB(mfs[lev]->nGrowVect(), Periodicity::NonPeriodic());
+            if (fb.m_RcvTags) {
+                for (auto const& [rank, tags] : *fb.m_RcvTags) {
+                    if (node(rank) != mynode) {
+                        for (auto const& tag : tags) {
+                            inter_node_cells += tag.dbox.numPts();
+                        }
+                    }
+                }
+            }
+        }
+        ParallelDescriptor::ReduceLongSum(inter_node_cells);
+    }
+
     if (ParallelDescriptor::IOProcessor()) {
         std::cout << "Using MPI" << '\n';
         std::cout << "----------------------------------------------" << '\n';
         std::cout << "Fill Boundary Time: " << wt1-wt0 << '\n';
+        std::cout << "Inter-node cells: " << inter_node_cells << '\n';
         std::cout << "----------------------------------------------" << '\n';
         std::cout << "ignore this line " << err << '\n';
     }
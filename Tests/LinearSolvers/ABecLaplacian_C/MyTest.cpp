@@ -97,8 +97,28 @@ MyTest::solvePoisson ()
             mlmg.setBottomSolver(MLMG::BottomSolver::petsc);
         }
 #endif
+        if (use_amg) {
+            mlmg.setBottomSolver(MLMG::BottomSolver::amg);
+        }
+        if (bottom_solver != MLMG::BottomSolver::Default) {
+            mlmg.setBottomSolver(bottom_solver);
+        }
 
         mlmg.solve(GetVecOfPtrs(solution), GetVecOfConstPtrs(rhs), tol_rel, tol_abs);
+
+        // The AMG bottom solver must leave the maxorder of the operator alone.
+        if (use_amg) {
+            AMREX_ALWAYS_ASSERT(mlpoisson.getMaxOrder() == linop_maxorder);
+        }
+
+        // Every bottom solve must converge before the default maximum
+        // number of iterations.
+        if (bottom_solver != MLMG::BottomSolver::Default) {
+            AMREX_ALWAYS_ASSERT(!mlmg.getNumCGIters().empty());
+            for (int n : mlmg.getNumCGIters()) {
+                AMREX_ALWAYS_ASSERT(n < 200);
+            }
+        }
     }
     else
     {
@@ -140,6 +160,12 @@ MyTest::solvePoisson ()
                 mlmg.setBottomSolver(MLMG::BottomSolver::petsc);
             }
 #endif
+            if (use_amg) {
+                mlmg.setBottomSolver(MLMG::BottomSolver::amg);
+            }
+            if (bottom_solver != MLMG::BottomSolver::Default) {
+                mlmg.setBottomSolver(bottom_solver);
+            }
 
             mlmg.solve({&solution[ilev]}, {&rhs[ilev]}, tol_rel, tol_abs);
         }
@@ -216,6 +242,12 @@ MyTest::solveABecLaplacian ()
             mlmg.setBottomSolver(MLMG::BottomSolver::petsc);
         }
 #endif
+        if (use_amg) {
+            mlmg.setBottomSolver(MLMG::BottomSolver::amg);
+        }
+        if (bottom_solver != MLMG::BottomSolver::Default) {
+            mlmg.setBottomSolver(bottom_solver);
+        }
 
         mlmg.solve(GetVecOfPtrs(solution), GetVecOfConstPtrs(rhs), tol_rel, tol_abs);
     }
@@ -273,6 +305,12 @@ MyTest::solveABecLaplacian ()
                 mlmg.setBottomSolver(MLMG::BottomSolver::petsc);
             }
 #endif
+            if (use_amg) {
+                mlmg.setBottomSolver(MLMG::BottomSolver::amg);
+            }
+            if (bottom_solver != MLMG::BottomSolver::Default) {
+                mlmg.setBottomSolver(bottom_solver);
+            }
 
             mlmg.solve({&solution[ilev]}, {&rhs[ilev]}, tol_rel, tol_abs);
         }
@@ -349,6 +387,12 @@ MyTest::solveABecLaplacianInhomNeumann ()
             mlmg.setBottomSolver(MLMG::BottomSolver::petsc);
         }
 #endif
+        if (use_amg) {
+            mlmg.setBottomSolver(MLMG::BottomSolver::amg);
+        }
+        if (bottom_solver != MLMG::BottomSolver::Default) {
+            mlmg.setBottomSolver(bottom_solver);
+        }
 
         mlmg.solve(GetVecOfPtrs(solution), GetVecOfConstPtrs(rhs), tol_rel, tol_abs);
     }
@@ -408,6 +452,12 @@ MyTest::solveABecLaplacianInhomNeumann ()
                 mlmg.setBottomSolver(MLMG::BottomSolver::petsc);
             }
 #endif
+            if (use_amg) {
+                mlmg.setBottomSolver(MLMG::BottomSolver::amg);
+            }
+            if (bottom_solver != MLMG::BottomSolver::Default) {
+                mlmg.setBottomSolver(bottom_solver);
+            }
 
             mlmg.solve({&solution[ilev]}, {&rhs[ilev]}, tol_rel, tol_abs);
         }
@@ -635,6 +685,24 @@ MyTest::readParameters ()
 #endif
     AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!(use_hypre && use_petsc),
                                      "use_hypre & use_petsc cannot be both true");
+    pp.query("use_amg", use_amg);
+    {
+        std::string bottom_solver_name;
+        pp.query("bottom_solver", bottom_solver_name);
+        if (bottom_solver_name == "bicgstab") {
+            bottom_solver = MLMG::BottomSolver::bicgstab;
+        } else if (bottom_solver_name == "cg") {
+            bottom_solver = MLMG::BottomSolver::cg;
+        } else if (bottom_solver_name == "pipelinedcg") {
+            bottom_solver = MLMG::BottomSolver::pipelinedcg;
+        } else if (bottom_solver_name == "sstepbicgstab") {
+            bottom_solver = MLMG::BottomSolver::sstepbicgstab;
+        } else if (!bottom_solver_name.empty()) {
+            amrex::Abort("Unknown bottom_solver " + bottom_solver_name);
+        }
+    }
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!use_amg || prob_type != 4,
+                                     "use_amg does not support the nodal solver");
 }
 
 void
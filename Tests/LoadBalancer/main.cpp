@@ -0,0 +1,100 @@
+#include <AMReX.H>
+#include <AMReX_LoadBalancer.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+namespace {
+
+// The boxes are dealt out round robin, and those of process 0 cost ten
+// times more than the others.
+struct Setup
+{
+    Setup ()
+    {
+        const int nprocs = ParallelDescriptor::NProcs();
+        ba = BoxArray(Box(IntVect(0), IntVect(AMREX_D_DECL(32*nprocs-1,31,31))));
+        ba.maxSize(16);
+        Vector<int> pmap(ba.size());
+        for (int i = 0; i < int(ba.size()); ++i) { pmap[i] = i % nprocs; }
+        dm = DistributionMapping(std::move(pmap));
+        for (int i = 0; i < int(ba.size()); ++i) {
+            imbalanced.push_back(dm[i] == 0 ? Real(10.0) : Real(1.0));
+        }
+        balanced.assign(ba.size(), Real(1.0));
+    }
+    BoxArray ba;
+    DistributionMapping dm;
+    Vector<Real> imbalanced;
+    Vector<Real> balanced;
+};
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        const Setup s;
+        const Real step_time = 1.0;
+        DistributionMapping new_dm;
+
+        if (ParallelDescriptor::NProcs() == 1) {
+            // There is nothing to gain on one process.
+            LoadBalancer lb(s.ba, s.dm);
+            lb.setCosts(s.imbalanced, step_time);
+            AMREX_ALWAYS_ASSERT(!lb.rebalance(new_dm, 100));
+        } else {
+            // An imbalance that pays off is removed.
+            {
+                LoadBalancer lb(s.ba, s.dm);
+                lb.setCosts(s.imbalanced, step_time);
+                lb.setRedistributionTime(Real(0.1));
+                AMREX_ALWAYS_ASSERT(lb.rebalance(new_dm, 100));
+                AMREX_ALWAYS_ASSERT(new_dm != s.dm && lb.DistributionMap() == new_dm);
+                AMREX_ALWAYS_ASSERT(lb.proposedEfficiency() > Real(1.05)*lb.currentEfficiency());
+                amrex::Print() << "efficiency " << lb.currentEfficiency() << " -> "
+                               << lb.proposedEfficiency() << "\n";
+
+                // The costs follow the boxes to the new map, so there is
+                // nothing more to gain.
+                AMREX_ALWAYS_ASSERT(!lb.rebalance(new_dm, 100));
+            }
+
+            // A balanced map is kept.
+            {
+                LoadBalancer lb(s.ba, s.dm);
+                lb.setCosts(s.balanced, step_time);
+                lb.setRedistributionTime(Real(0.0));
+                AMREX_ALWAYS_ASSERT(!lb.rebalance(new_dm, 100));
+            }
+
+            // The saving over a few steps does not pay for the
+            // redistribution.
+            {
+                LoadBalancer lb(s.ba, s.dm);
+                lb.setCosts(s.imbalanced, step_time);
+                lb.setRedistributionTime(Real(10.0));
+                AMREX_ALWAYS_ASSERT(!lb.rebalance(new_dm, 2));
+                AMREX_ALWAYS_ASSERT(lb.DistributionMap() == s.dm);
+                AMREX_ALWAYS_ASSERT(lb.rebalance(new_dm, 100));
+            }
+
+            // The gain is below loadbalance.min_gain.
+            {
+                ParmParse pp("loadbalance");
+                pp.remove("min_gain");
+                pp.add("min_gain", Real(10.0));
+                LoadBalancer lb(s.ba, s.dm);
+                lb.setCosts(s.imbalanced, step_time);
+                lb.setRedistributionTime(Real(0.0));
+                AMREX_ALWAYS_ASSERT(!lb.rebalance(new_dm, 100));
+                AMREX_ALWAYS_ASSERT(lb.DistributionMap() == s.dm);
+            }
+        }
+
+        amrex::Print() << "All LoadBalancer tests passed\n";
+    }
+    amrex::Finalize();
+}
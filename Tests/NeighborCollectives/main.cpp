@@ -0,0 +1,145 @@
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Print.H>
+
+#include <cstring>
+
+using namespace amrex;
+
+namespace {
+
+// Valid cells get unique values, and ghost cells -1.
+void init (MultiFab& mf, int seed)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        const Box& vbx = mfi.validbox();
+        auto const& a = mf.array(mfi);
+        ParallelFor(mfi.fabbox(), mf.nComp(), [=] AMREX_GPU_DEVICE (int i, int j, int k, int n)
+        {
+            a(i,j,k,n) = vbx.contains(IntVect(AMREX_D_DECL(i,j,k)))
+                ? Real(seed) + Real(i+1) + Real(100*(j+1)) + Real(10000*(k+1)) + Real(1000000*n)
+                : Real(-1.0);
+        });
+    }
+}
+
+DistributionMapping make_dm (BoxArray const& ba, int shift)
+{
+    const int nprocs = ParallelDescriptor::NProcs();
+    Vector<int> pmap(ba.size());
+    for (int i = 0; i < int(ba.size()); ++i) {
+        pmap[i] = (i*7 + shift) % nprocs;
+    }
+    return DistributionMapping(std::move(pmap));
+}
+
+// Run the communication operations, and return the results.
+Vector<MultiFab> run (Geometry const& geom, BoxArray const& ba, BoxArray const& ba2)
+{
+    const auto period = geom.periodicity();
+    const DistributionMapping dm = make_dm(ba, 0);
+    const DistributionMapping dm2 = make_dm(ba2, 1);
+    Vector<MultiFab> r;
+
+    // FillBoundary of all ghost cells with periodicity
+    {
+        MultiFab mf(ba, dm, 3, 2);
+        init(mf, 0);
+        mf.FillBoundary(period);
+        r.push_back(std::move(mf));
+    }
+
+    // FillBoundary of some components and ghost cells, without waiting
+    {
+        MultiFab mf(ba, dm, 3, 2);
+        init(mf, 0);
+        mf.FillBoundary_nowait(1, 2, IntVect(1), period);
+        mf.FillBoundary_finish();
+        r.push_back(std::move(mf));
+    }
+
+    // FillBoundary and SumBoundary of nodal data
+    {
+        MultiFab mf(amrex::convert(ba, IndexType::TheNodeType()), dm, 2, 1);
+        init(mf, 0);
+        mf.FillBoundary(period);
+        r.push_back(std::move(mf));
+
+        MultiFab mf2(amrex::convert(ba, IndexType::TheNodeType()), dm, 2, 1);
+        init(mf2, 0);
+        mf2.SumBoundary(period);
+        r.push_back(std::move(mf2));
+    }
+
+    // ParallelCopy between different grids, in several passes
+    {
+        MultiFab src(ba2, dm2, 3, 1);
+        init(src, 7);
+        MultiFab dst(ba, dm, 3, 2);
+        init(dst, 0);
+        const int max_comp = FabArrayBase::MaxComp;
+        FabArrayBase::MaxComp = 2;
+        dst.ParallelCopy(src, 0, 0, 3, IntVect(1), IntVect(2), period);
+        FabArrayBase::MaxComp = max_comp;
+        r.push_back(std::move(dst));
+    }
+
+    // ParallelCopy with addition
+    {
+        MultiFab src(ba2, dm2, 2, 0);
+        init(src, 7);
+        MultiFab dst(ba, dm, 3, 1);
+        init(dst, 0);
+        dst.ParallelCopy(src, 0, 1, 2, IntVect(0), IntVect(1), period, FabArrayBase::ADD);
+        r.push_back(std::move(dst));
+    }
+
+    return r;
+}
+
+Long count_diff (MultiFab const& a, MultiFab const& b)
+{
+    Long ndiff = 0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi) {
+        FArrayBox fa(a[mfi].box(), a.nComp(), The_Pinned_Arena());
+        FArrayBox fb(b[mfi].box(), b.nComp(), The_Pinned_Arena());
+        fa.copy<RunOn::Device>(a[mfi]);
+        fb.copy<RunOn::Device>(b[mfi]);
+        Gpu::streamSynchronize();
+        ndiff += (std::memcmp(fa.dataPtr(), fb.dataPtr(), fa.nBytes()) != 0);
+    }
+    ParallelDescriptor::ReduceLongSum(ndiff);
+    return ndiff;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        Box domain(IntVect(0), IntVect(AMREX_D_DECL(63,47,31)));
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Geometry geom(domain, rb, CoordSys::cartesian, {AMREX_D_DECL(1,1,0)});
+        BoxArray ba(domain);
+        ba.maxSize(16);
+        BoxArray ba2(domain);
+        ba2.maxSize(IntVect(AMREX_D_DECL(8,24,12)));
+
+        FabArrayBase::use_neighbor_collectives = false;
+        const auto expected = run(geom, ba, ba2);
+
+        FabArrayBase::use_neighbor_collectives = true;
+        const auto result = run(geom, ba, ba2);
+
+        AMREX_ALWAYS_ASSERT(expected.size() == result.size());
+        for (int i = 0; i < int(result.size()); ++i) {
+            const Long ndiff = count_diff(result[i], expected[i]);
+            amrex::Print() << "  case " << i << ": " << ndiff << " FABs differ\n";
+            AMREX_ALWAYS_ASSERT(ndiff == 0);
+        }
+
+        amrex::Print() << "Neighborhood collectives give the same results as point-to-point messages\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,127 @@
+#include <AMReX.H>
+#include <AMReX_OpenMP.H>
+#include <AMReX_Print.H>
+#include <AMReX_TArena.H>
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace amrex;
+
+namespace {
+
+// Every size maps to the smallest class that holds it.
+void test_size_classes ()
+{
+    for (std::size_t n = 1; n <= TArena::MaxCachedSize; n += 1 + n/7) {
+        const int c = TArena::sizeClass(n);
+        AMREX_ALWAYS_ASSERT(c >= 0 && c < TArena::NumSizeClasses);
+        AMREX_ALWAYS_ASSERT(TArena::classSize(c) >= n);
+        AMREX_ALWAYS_ASSERT(c == 0 || TArena::classSize(c-1) < n);
+    }
+    AMREX_ALWAYS_ASSERT(TArena::sizeClass(TArena::MaxCachedSize+1) == -1);
+}
+
+// Blocks allocated by each thread are written, and then freed by another
+// thread.
+void test_cross_thread (TArena& arena, int nthreads)
+{
+    constexpr int nblocks = 200;
+    std::vector<std::vector<char*>> blocks(nthreads);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nthreads; ++t) {
+        threads.emplace_back([&, t] ()
+        {
+            for (int i = 0; i < nblocks; ++i) {
+                std::size_t n = 8 + std::size_t(i*37 + t*101) % 20000;
+                auto* p = static_cast<char*>(arena.alloc(n));
+                std::memset(p, t, n);
+                blocks[t].push_back(p);
+            }
+        });
+    }
+    for (auto& th : threads) { th.join(); }
+    threads.clear();
+
+    AMREX_ALWAYS_ASSERT(arena.heap_space_actually_used() > 0);
+
+    for (int t = 0; t < nthreads; ++t) {
+        threads.emplace_back([&, t] ()
+        {
+            const int owner = (t+1) % nthreads;
+            for (auto* p : blocks[owner]) {
+                AMREX_ALWAYS_ASSERT(p[0] == char(owner));
+                arena.free(p);
+            }
+        });
+    }
+    for (auto& th : threads) { th.join(); }
+
+    AMREX_ALWAYS_ASSERT(arena.heap_space_actually_used() == 0);
+}
+
+// Freeing more than the cache size flushes the largest blocks to the pool.
+void test_flush (TArena& arena, std::size_t cache_size)
+{
+    std::vector<void*> blocks;
+    for (int i = 0; i < 64; ++i) {
+        blocks.push_back(arena.alloc(cache_size/16));
+    }
+    AMREX_ALWAYS_ASSERT(arena.heap_space_actually_used() >= 4*cache_size);
+    for (auto* p : blocks) {
+        arena.free(p);
+        AMREX_ALWAYS_ASSERT(arena.heap_space_cached() <= cache_size);
+    }
+    AMREX_ALWAYS_ASSERT(arena.heap_space_cached() > 0);
+    AMREX_ALWAYS_ASSERT(arena.heap_space_actually_used() == 0);
+}
+
+// The slot of a thread that has exited is reused, so the caches keep
+// working however many threads have come and gone.
+void test_slot_reuse (TArena& arena)
+{
+    constexpr std::size_t n = 1000;
+    const int nslots = std::max(2*OpenMP::get_max_threads(), 8);
+    for (int t = 0; t < 4*nslots; ++t) {
+        std::thread th([&] ()
+        {
+            // The block freed by the previous thread is found in the cache.
+            const std::size_t cached = arena.heap_space_cached();
+            void* p = arena.alloc(n);
+            AMREX_ALWAYS_ASSERT(t == 0 || arena.heap_space_cached() < cached);
+            arena.free(p);
+        });
+        th.join();
+    }
+    AMREX_ALWAYS_ASSERT(arena.heap_space_actually_used() == 0);
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        test_size_classes();
+
+        const std::size_t cache_size = 1024*1024;
+        TArena arena(cache_size);
+
+        const int nthreads = std::max(OpenMP::get_max_threads(), 4);
+        test_cross_thread(arena, nthreads);
+        test_flush(arena, cache_size);
+        test_slot_reuse(arena);
+
+        // Everything goes back to the system.
+        arena.freeUnused();
+        AMREX_ALWAYS_ASSERT(arena.heap_space_cached() == 0);
+        AMREX_ALWAYS_ASSERT(arena.heap_space_used() == 0);
+        AMREX_ALWAYS_ASSERT(arena.heap_space_actually_used() == 0);
+
+        amrex::Print() << "All TArena tests passed\n";
+    }
+    amrex::Finalize();
+}
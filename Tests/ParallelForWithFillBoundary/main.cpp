@@ -0,0 +1,131 @@
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Print.H>
+
+#include <cstring>
+
+using namespace amrex;
+
+namespace {
+
+// Valid cells get unique values, and ghost cells -1.
+void init (MultiFab& mf)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        const Box& vbx = mfi.validbox();
+        auto const& a = mf.array(mfi);
+        ParallelFor(mfi.fabbox(), mf.nComp(), [=] AMREX_GPU_DEVICE (int i, int j, int k, int n)
+        {
+            a(i,j,k,n) = vbx.contains(IntVect(AMREX_D_DECL(i,j,k)))
+                ? Real(i+1) + Real(100*(j+1)) + Real(10000*(k+1)) + Real(1000000*n)
+                : Real(-1.0);
+        });
+    }
+}
+
+// The sum of the cells within ng of (i,j,k) in component n, weighted so
+// that a cell in the wrong place changes the result.
+struct Stencil
+{
+    MultiArray4<Real const> phi;
+    Dim3 ng;
+    int n;
+
+    [[nodiscard]] AMREX_GPU_DEVICE AMREX_FORCE_INLINE
+    Real operator() (int b, int i, int j, int k) const noexcept
+    {
+        Real r = 0.0;
+        Real w = 1.0;
+        for (int kk = k-ng.z; kk <= k+ng.z; ++kk) {
+        for (int jj = j-ng.y; jj <= j+ng.y; ++jj) {
+        for (int ii = i-ng.x; ii <= i+ng.x; ++ii) {
+            r += w * phi[b](ii,jj,kk,n);
+            w += Real(1.0);
+        }}}
+        return r;
+    }
+};
+
+Long count_diff (MultiFab const& a, MultiFab const& b)
+{
+    Long ndiff = 0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi) {
+        FArrayBox fa(a[mfi].box(), a.nComp(), The_Pinned_Arena());
+        FArrayBox fb(b[mfi].box(), b.nComp(), The_Pinned_Arena());
+        fa.copy<RunOn::Device>(a[mfi]);
+        fb.copy<RunOn::Device>(b[mfi]);
+        Gpu::streamSynchronize();
+        ndiff += (std::memcmp(fa.dataPtr(), fb.dataPtr(), fa.nBytes()) != 0);
+    }
+    ParallelDescriptor::ReduceLongSum(ndiff);
+    return ndiff;
+}
+
+// Apply the stencil to component n after filling ncomp components from
+// scomp, first with FillBoundary followed by ParallelFor, and then with
+// ParallelForWithFillBoundary.
+void test (BoxArray const& ba, DistributionMapping const& dm, Periodicity const& period,
+           int scomp, int ncomp, int n, IntVect const& ng)
+{
+    MultiFab phi_a(ba, dm, 3, 2);
+    MultiFab phi_b(ba, dm, 3, 2);
+    MultiFab rhs_a(ba, dm, 1, 0);
+    MultiFab rhs_b(ba, dm, 1, 0);
+    init(phi_a);
+    init(phi_b);
+    rhs_a.setVal(-2.0);
+    rhs_b.setVal(-2.0);
+
+    phi_a.FillBoundary(scomp, ncomp, ng, period);
+    {
+        Stencil s{phi_a.const_arrays(), ng.dim3(), n};
+        auto const& rhs = rhs_a.arrays();
+        ParallelFor(rhs_a, [=] AMREX_GPU_DEVICE (int b, int i, int j, int k)
+        {
+            rhs[b](i,j,k) = s(b,i,j,k);
+        });
+    }
+
+    // The second call uses the cached boxes.
+    for (int icall = 0; icall < 2; ++icall) {
+        Stencil s{phi_b.const_arrays(), ng.dim3(), n};
+        auto const& rhs = rhs_b.arrays();
+        ParallelForWithFillBoundary(phi_b, scomp, ncomp, ng, period,
+        [=] AMREX_GPU_DEVICE (int b, int i, int j, int k)
+        {
+            rhs[b](i,j,k) = s(b,i,j,k);
+        });
+        Gpu::streamSynchronize();
+
+        const Long ndiff = count_diff(rhs_a, rhs_b) + count_diff(phi_a, phi_b);
+        amrex::Print() << "  ng " << ng << ", components " << scomp << " to "
+                       << scomp+ncomp-1 << ", call " << icall << ": "
+                       << ndiff << " FABs differ\n";
+        AMREX_ALWAYS_ASSERT(ndiff == 0);
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        // Some boxes are thinner than twice the ghost width, so they only
+        // have boundary cells.
+        Box domain(IntVect(0), IntVect(AMREX_D_DECL(63,50,34)));
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Geometry geom(domain, rb, CoordSys::cartesian, {AMREX_D_DECL(1,1,0)});
+        BoxArray ba(domain);
+        ba.maxSize(16);
+        DistributionMapping dm(ba);
+
+        test(ba, dm, geom.periodicity(), 0, 3, 2, IntVect(2));
+        test(ba, dm, geom.periodicity(), 1, 1, 1, IntVect(1));
+        test(ba, dm, geom.periodicity(), 0, 2, 0, IntVect(AMREX_D_DECL(2,1,0)));
+        test(ba, dm, Periodicity::NonPeriodic(), 0, 3, 1, IntVect(2));
+
+        amrex::Print() << "ParallelForWithFillBoundary gives the same results as FillBoundary and ParallelFor\n";
+    }
+    amrex::Finalize();
+}
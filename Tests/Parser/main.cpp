@@ -1,6 +1,12 @@
 #include <AMReX.H>
 #include <AMReX_Parser.H>
 #include <AMReX_IParser.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_FArrayBox.H>
+#include <AMReX_FileSystem.H>
+#include <AMReX_Random.H>
+#include <cmath>
+#include <cstring>
 #include <map>
 
 using namespace amrex;
@@ -369,6 +375,198 @@ int main (int argc, char* argv[])
         amrex::Print() << "\n";
     }
 
+    {
+        amrex::Print() << "Testing common subexpression elimination\n";
+        int count = 0;
+        ParmParse pp("amrex");
+        // The results with and without the elimination must be the same.
+        auto test_cse = [&] (std::string const& f, bool fewer)
+        {
+            amrex::Print() << count++ << ". Testing \"" << f << "\"\n";
+            pp.add("parser_cse", true);
+            Parser parser(f);
+            parser.registerVariables({"x","y","z"});
+            auto const exe = parser.compile<3>();
+            pp.add("parser_cse", false);
+            Parser parser0(f);
+            parser0.registerVariables({"x","y","z"});
+            auto const exe0 = parser0.compile<3>();
+            pp.add("parser_cse", true);
+
+            AMREX_ALWAYS_ASSERT(parser0.instructionCount() == parser0.instructionCount(false));
+            AMREX_ALWAYS_ASSERT(parser.instructionCount(false) == parser0.instructionCount());
+            if (fewer) {
+                AMREX_ALWAYS_ASSERT(parser.instructionCount() < parser0.instructionCount());
+            } else {
+                AMREX_ALWAYS_ASSERT(parser.instructionCount() <= parser0.instructionCount());
+            }
+
+            const int N = 20;
+            for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j) {
+            for (int k = 0; k < N; ++k) {
+                double x = -1.3 + 3.0*i/(N-1);
+                double y = -0.7 + 2.0*j/(N-1);
+                double z = -2.1 + 4.0*k/(N-1);
+                double r = exe(x,y,z);
+                double r0 = exe0(x,y,z);
+                AMREX_ALWAYS_ASSERT(r == r0 || (std::isnan(r) && std::isnan(r0)));
+            }}}
+        };
+        test_cse("sqrt(x*x+y*y)*sin(sqrt(x*x+y*y)) + exp(-sqrt(x*x+y*y))", true);
+        test_cse("log(x*x+y*y+z*z)*sqrt(x*x+y*y+z*z)", true);
+        test_cse("(x+y)*(x+y) + z*(x+y) - sin(z*(x+y))", false);
+        test_cse("exp(-(x-0.3)**2/(2*z*z)) + exp(-(y-0.3)**2/(2*z*z))", false);
+        test_cse("r2=x*x+y*y; r=sqrt(r2); r*sin(r) + exp(-sqrt(x*x+y*y)) + r2*(x*x+y*y)", true);
+        test_cse("if(x*y < 0.1, sin(x*y)*cos(x*y), z) + x*y", false);
+        test_cse("if(x < 0, sin(y*z)+cos(y*z), tan(y*z))", false);
+        test_cse("sin(x*y+z)*sin(x*y+z) + cos(x*y+z)", false);
+        test_cse("exp(-(x*x+y*y)/(z*z+1))*x + exp(-(x*x+y*y)/(z*z+1))*y", false);
+        test_cse("pow(x,3) + pow(x,4)*y + pow(z,3)*pow(y,4)", false);
+        test_cse("a=x*y; b=a*z; a*a + b*b", false);
+
+        amrex::Print() << count++ << ". Testing \"pow(x,3)\" and \"pow(x,4)\"\n";
+        {
+            Parser p3("pow(x,3)");
+            p3.registerVariables({"x"});
+            auto const exe3 = p3.compileHost<1>();
+            Parser p4("pow(x,4)");
+            p4.registerVariables({"x"});
+            auto const exe4 = p4.compileHost<1>();
+            for (int i = 0; i < 1000; ++i) {
+                double x = -2.0 + 4.0*i/999.;
+                AMREX_ALWAYS_ASSERT(exe3(x) == x*(x*x));
+                AMREX_ALWAYS_ASSERT(exe4(x) == (x*x)*(x*x));
+            }
+        }
+        amrex::Print() << "\nAll common subexpression tests passed\n\n";
+    }
+
+    {
+        amrex::Print() << "Testing batch evaluation\n";
+        int count = 0;
+        // evalBatch and fill must give the same results as operator().
+        auto test_batch = [&] (std::string const& f)
+        {
+            amrex::Print() << count++ << ". Testing \"" << f << "\"\n";
+            Parser parser(f);
+            parser.registerVariables({"x","y","z"});
+            auto const exe = parser.compileHost<3>();
+
+            // The points are sorted in x, so that most batches take the
+            // same branch of if, while some do not. The number of points is
+            // not a multiple of the batch size.
+            const int npts = 1000;
+            Vector<double> x(npts), y(npts), z(npts), r(npts);
+            for (int m = 0; m < npts; ++m) {
+                x[m] = -1.5 + 3.0*m/(npts-1);
+                y[m] = -1.0 + 2.0*amrex::Random();
+                z[m] = 0.1 + amrex::Random();
+            }
+            exe.evalBatch(npts, GpuArray<double const*,3>{x.data(), y.data(), z.data()},
+                          r.data());
+            for (int m = 0; m < npts; ++m) {
+                double r0 = exe(x[m],y[m],z[m]);
+                AMREX_ALWAYS_ASSERT(r[m] == r0 || (std::isnan(r[m]) && std::isnan(r0)));
+            }
+
+            Box bx(IntVect(AMREX_D_DECL(-3,2,0)), IntVect(AMREX_D_DECL(146,6,4)));
+            FArrayBox fab(bx, 2);
+            fab.setVal<RunOn::Host>(0.0);
+            Array4<Real> const& a = fab.array();
+            auto xyz = [] (int i, int j, int k) -> GpuArray<double,3>
+            {
+                return {0.02*i - 1.0, 0.3*j - 1.2, 0.5 + 0.25*k};
+            };
+            exe.fill(bx, a, 1, xyz);
+            amrex::LoopOnCpu(bx, [&] (int i, int j, int k)
+            {
+                auto v = xyz(i,j,k);
+                auto r0 = static_cast<Real>(exe(v[0],v[1],v[2]));
+                AMREX_ALWAYS_ASSERT(a(i,j,k,0) == Real(0.0));
+                AMREX_ALWAYS_ASSERT(a(i,j,k,1) == r0 || (std::isnan(a(i,j,k,1)) && std::isnan(r0)));
+            });
+        };
+        test_batch("x*y + z");
+        test_batch("x**3*y - 2*x**4 + z**2 + y**-3 + x**7");
+        test_batch("if(x < y, x**5, -y**-3) + z");
+        test_batch("r=x*y; if(r > 0.25, log(r), r**7) + atan2(y,x)*z");
+        test_batch("if(x < 0, if(y < 0, sin(x*y), cos(x*z)), sqrt(x*x+y*y+z*z))");
+        test_batch("min(x,y)*max(y,z) + heaviside(x,0.5) + fmod(z,0.3)");
+        test_batch("sqrt(x*x+y*y)*sin(sqrt(x*x+y*y)) + exp(-sqrt(x*x+y*y))*z");
+        amrex::Print() << "\nAll batch evaluation tests passed\n\n";
+    }
+
+#ifdef AMREX_PARSER_NATIVE
+    {
+        amrex::Print() << "Testing native compilation\n";
+        int count = 0;
+        const std::string cache_dir = "parser_native_cache";
+        if (ParallelDescriptor::IOProcessor()) {
+            FileSystem::RemoveAll(cache_dir);
+        }
+        ParallelDescriptor::Barrier();
+        ParmParse pp("amrex");
+        pp.add("parser_native_cache_dir", cache_dir);
+
+        // compileNative must give the same results as the bytecode, either
+        // because it falls back to the bytecode or because the native code
+        // does the same operations.
+        auto test_native = [&] (std::string const& f, bool expect_native)
+        {
+            amrex::Print() << count++ << ". Testing \"" << f << "\"\n";
+            Parser parser(f);
+            parser.registerVariables({"x","y","z"});
+            auto const exe = parser.compileHost<3>();
+            auto const nexe = parser.compileNative<3>();
+            AMREX_ALWAYS_ASSERT((nexe.m_native != nullptr) == expect_native);
+            AMREX_ALWAYS_ASSERT((nexe.m_native_batch != nullptr) == expect_native);
+
+            const int npts = 1000;
+            Vector<double> x(npts), y(npts), z(npts), r(npts);
+            for (int m = 0; m < npts; ++m) {
+                x[m] = -1.5 + 3.0*m/(npts-1);
+                y[m] = -1.0 + 2.0*amrex::Random();
+                z[m] = 0.1 + amrex::Random();
+            }
+            nexe.evalBatch(npts, GpuArray<double const*,3>{x.data(), y.data(), z.data()},
+                           r.data());
+            for (int m = 0; m < npts; ++m) {
+                double r0 = exe(x[m],y[m],z[m]);
+                double r1 = nexe(x[m],y[m],z[m]);
+                AMREX_ALWAYS_ASSERT(std::memcmp(&r0, &r1, sizeof(double)) == 0);
+                AMREX_ALWAYS_ASSERT(std::memcmp(&r0, &r[m], sizeof(double)) == 0);
+            }
+        };
+        Vector<std::string> exprs{
+            "x*y + z",
+            "x**3*y - 2*x**4 + z**2 + y**-3 + x**7",
+            "r=x*y; if(r > 0.25, log(r), r**7) + atan2(y,x)*z",
+            "if(x < 0, if(y < 0, sin(x*y), cos(x*z)), sqrt(x*x+y*y+z*z))",
+            "min(x,y)*max(y,z) + heaviside(x,0.5) + fmod(z,0.3)",
+            "sqrt(x*x+y*y)*sin(sqrt(x*x+y*y)) + exp(-sqrt(x*x+y*y))*z"};
+
+        // A compiler that does not exist makes compileNative fall back to
+        // the bytecode.
+        pp.add("parser_native_compiler", std::string("amrex-no-such-compiler"));
+        for (auto const& f : exprs) {
+            test_native(f, false);
+        }
+
+        // A real compiler gives native code. The second round loads the
+        // libraries cached on disk.
+        pp.remove("parser_native_compiler");
+        for (int round = 0; round < 2; ++round) {
+            for (auto const& f : exprs) {
+                test_native(f, true);
+            }
+        }
+
+        pp.remove("parser_native_cache_dir");
+        amrex::Print() << "\nAll native compilation tests passed\n\n";
+    }
+#endif
+
     {
         int count = 0;
         int x = 11;
@@ -0,0 +1,153 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_Random.H>
+#include <AMReX_ParticleTileMap.H>
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+using namespace amrex;
+
+namespace {
+
+using Key = std::pair<int,int>;
+
+// Check that the tile map has the same elements, in the same order, as the
+// std::map it mirrors.
+void check_same (ParticleTileMap<int> const& m, std::map<Key,int> const& ref)
+{
+    AMREX_ALWAYS_ASSERT(m.size() == ref.size());
+    AMREX_ALWAYS_ASSERT(m.empty() == ref.empty());
+    auto it = m.begin();
+    for (auto const& kv : ref) {
+        AMREX_ALWAYS_ASSERT(it != m.end());
+        AMREX_ALWAYS_ASSERT(it->first == kv.first && it->second == kv.second);
+        ++it;
+    }
+    AMREX_ALWAYS_ASSERT(it == m.end());
+    for (auto const& kv : ref) {
+        AMREX_ALWAYS_ASSERT(m.count(kv.first) == 1);
+        AMREX_ALWAYS_ASSERT(m.at(kv.first) == kv.second);
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        ParticleTileMap<int> m;
+        std::map<Key,int> ref;
+
+        amrex::Print() << "Testing insertions out of order\n";
+        for (int n = 0; n < 2000; ++n) {
+            Key key(int(amrex::Random_int(50)), int(amrex::Random_int(8)));
+            m[key] = n;
+            ref[key] = n;
+        }
+        check_same(m, ref);
+
+        amrex::Print() << "Testing references across insertions and erasures\n";
+        std::vector<std::pair<Key,int*>> refs;
+        for (auto& kv : m) {
+            if (kv.first.second == 0) {
+                refs.emplace_back(kv.first, &kv.second);
+            }
+        }
+        AMREX_ALWAYS_ASSERT(!refs.empty());
+
+        amrex::Print() << "Testing erase(it++) during iteration\n";
+        for (auto it = m.begin(); it != m.end(); ) {
+            if (it->first.second != 0 && it->second % 3 == 0) {
+                ref.erase(it->first);
+                m.erase(it++);
+            } else {
+                ++it;
+            }
+        }
+        check_same(m, ref);
+
+        amrex::Print() << "Testing erase returning the next element\n";
+        for (auto it = m.begin(); it != m.end(); ) {
+            if (it->first.second != 0 && it->second % 3 == 1) {
+                ref.erase(it->first);
+                it = m.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        check_same(m, ref);
+
+        amrex::Print() << "Testing nested iteration and find on a const map\n";
+        {
+            // Leave an erased slot in front of the element found.
+            auto victim = std::find_if(ref.begin(), ref.end(),
+                                       [] (auto const& kv) { return kv.first.second != 0; });
+            AMREX_ALWAYS_ASSERT(victim != ref.end());
+            Key last = ref.rbegin()->first;
+            m.erase(victim->first);
+            ref.erase(victim);
+
+            auto const& cm = m;
+            auto found = cm.find(last);
+            AMREX_ALWAYS_ASSERT(found != cm.end());
+            std::size_t npairs = 0;
+            for (auto it = cm.begin(); it != cm.end(); ++it) {
+                for (auto jt = cm.begin(); jt != it; ++jt) {
+                    AMREX_ALWAYS_ASSERT(jt->first < it->first);
+                    ++npairs;
+                }
+            }
+            AMREX_ALWAYS_ASSERT(npairs == cm.size()*(cm.size()-1)/2);
+            // The iterator from find is still valid after the loops.
+            AMREX_ALWAYS_ASSERT(found != cm.end() && found->first == last);
+            AMREX_ALWAYS_ASSERT(++found == cm.end());
+        }
+
+        amrex::Print() << "Testing appends during iteration\n";
+        {
+            int next_grid = ref.rbegin()->first.first + 1;
+            auto it = m.find(refs.front().first);
+            for (int n = 0; n < 10; ++n) {
+                Key key(next_grid+n, 0);
+                m.try_emplace(key, -n);
+                ref[key] = -n;
+            }
+            AMREX_ALWAYS_ASSERT(it->first == refs.front().first);
+            check_same(m, ref);
+        }
+
+        amrex::Print() << "Testing insertions after erasures\n";
+        for (int n = 0; n < 500; ++n) {
+            Key key(int(amrex::Random_int(60)), int(amrex::Random_int(8)));
+            if (amrex::Random_int(2) == 0) {
+                AMREX_ALWAYS_ASSERT(m.erase(key) == ref.erase(key));
+            } else if (key.second != 0) {
+                auto [it, inserted] = m.try_emplace(key, n);
+                auto [rit, rinserted] = ref.try_emplace(key, n);
+                AMREX_ALWAYS_ASSERT(inserted == rinserted);
+                AMREX_ALWAYS_ASSERT(it->first == key && it->second == rit->second);
+            }
+        }
+        check_same(m, ref);
+
+        for (auto const& [key, p] : refs) {
+            if (ref.count(key) > 0) {
+                AMREX_ALWAYS_ASSERT(&m.at(key) == p);
+            }
+        }
+
+        amrex::Print() << "Testing copy and clear\n";
+        ParticleTileMap<int> m2 = m;
+        check_same(m2, ref);
+        m.clear();
+        check_same(m, std::map<Key,int>{});
+        check_same(m2, ref);
+
+        amrex::Print() << "All ParticleTileMap tests passed\n";
+    }
+    amrex::Finalize();
+}
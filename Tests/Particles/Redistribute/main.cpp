@@ -263,6 +263,14 @@ public:
         }
     }
 
+    //! Number of particlePostLocate calls on all ranks
+    Long numPostLocateCalls () const
+    {
+        Long n = m_num_post_locate;
+        ParallelDescriptor::ReduceLongSum(n);
+        return n;
+    }
+
     void checkAnswer () const
     {
         BL_PROFILE("TestParticleContainer::checkAnswer");
@@ -313,6 +321,19 @@ public:
             }
         }
     }
+
+private:
+
+    void particlePostLocate (ParticleType& /*p*/, const ParticleLocData& /*pld*/,
+                             const int /*lev*/) override
+    {
+#ifdef AMREX_USE_OMP
+#pragma omp atomic
+#endif
+        ++m_num_post_locate;
+    }
+
+    Long m_num_post_locate = 0;
 };
 
 struct TestParams
@@ -332,6 +353,7 @@ struct TestParams
 };
 
 void testRedistribute();
+void testCopyPlanCache();
 
 int main (int argc, char* argv[])
 {
@@ -339,6 +361,7 @@ int main (int argc, char* argv[])
 
     amrex::Print() << "Running redistribute test \n";
     testRedistribute();
+    testCopyPlanCache();
 
     amrex::Finalize();
 }
@@ -436,7 +459,13 @@ void testRedistribute ()
             AMREX_ALWAYS_ASSERT(old == pc.TotalNumberOfParticles(false));
             pc.negateEven();
         }
+        auto num_calls = pc.numPostLocateCalls();
+        auto np_valid = pc.TotalNumberOfParticles();
         pc.RedistributeLocal();
+        // The host algorithms locate every valid particle once.
+        if (Gpu::notInLaunchRegion()) {
+            AMREX_ALWAYS_ASSERT(pc.numPostLocateCalls() - num_calls == np_valid);
+        }
         if (params.sort) { pc.SortParticlesByCell(); }
         pc.checkAnswer();
     }
@@ -506,3 +535,83 @@ void testRedistribute ()
     // the way this test is set up, if we make it here we pass
     amrex::Print() << "pass \n";
 }
+
+// With particles.use_persistent_copy_plan, check when the neighbor graph
+// of the copy plan is reused and when it is rebuilt. Box i is on rank i,
+// so moving the particles by one box width sends everything from rank i
+// to rank i+1.
+void testCopyPlanCache ()
+{
+    BL_PROFILE("testCopyPlanCache");
+
+    const int NProcs = ParallelDescriptor::NProcs();
+    const int MyProc = ParallelDescriptor::MyProc();
+    const int width = 8;
+
+    const Box domain(IntVect(0), IntVect(AMREX_D_DECL(NProcs*width-1, 15, 15)));
+    RealBox real_box({AMREX_D_DECL(0.,0.,0.)},
+                     {AMREX_D_DECL(Real(NProcs*width), 16., 16.)});
+    Vector<Geometry> geom(1);
+    geom[0].define(domain, real_box, CoordSys::cartesian, {AMREX_D_DECL(1,1,1)});
+
+    BoxList bl;
+    Vector<int> pmap;
+    for (int i = 0; i < NProcs; ++i) {
+        Box b = domain;
+        b.setSmall(0, i*width);
+        b.setBig(0, (i+1)*width-1);
+        bl.push_back(b);
+        pmap.push_back(i);
+    }
+    Vector<BoxArray> ba{BoxArray(bl)};
+    Vector<DistributionMapping> dm{DistributionMapping(pmap)};
+
+    TestParticleContainer pc(geom, dm, ba, Vector<IntVect>{});
+    if (!pc.usePersistentCopyPlan() || NProcs == 1) { return; }
+
+    amrex::Print() << "Running copy plan cache test \n";
+
+    pc.InitParticles(IntVect(1));
+    const auto np = pc.TotalNumberOfParticles();
+    const auto& cache = pc.CopyPlanCache();
+    const int next = (MyProc+1) % NProcs;
+    const int prev = (MyProc+NProcs-1) % NProcs;
+
+    auto redistribute = [&] (int shift) {
+        pc.moveParticles(IntVect(AMREX_D_DECL(shift*width,0,0)), 0);
+        pc.RedistributeGlobal();
+        pc.checkAnswer();
+        AMREX_ALWAYS_ASSERT(pc.TotalNumberOfParticles() == np);
+    };
+
+    // The first call builds a graph without neighbors, and the second one
+    // reuses it.
+    redistribute(0);
+    const int nupdates = cache.numUpdates();
+    redistribute(0);
+    AMREX_ALWAYS_ASSERT(cache.numUpdates() == nupdates);
+    AMREX_ALWAYS_ASSERT(!cache.isNeighbor(next) && !cache.isNeighbor(prev));
+
+    // Sending to a rank that is not a neighbor rebuilds the graph.
+    redistribute(1);
+    AMREX_ALWAYS_ASSERT(cache.numUpdates() == nupdates+1);
+    AMREX_ALWAYS_ASSERT(cache.isNeighbor(next) && cache.isNeighbor(prev));
+
+    // Going back and forth between the same neighbors reuses it.
+    for (int i = 0; i < 4; ++i) {
+        redistribute(-1);
+        redistribute(1);
+    }
+    AMREX_ALWAYS_ASSERT(cache.numUpdates() == nupdates+1);
+
+    // Neighbors idle for m_max_idle calls are dropped at the next one.
+    for (int i = 0; i < cache.m_max_idle; ++i) {
+        redistribute(0);
+    }
+    AMREX_ALWAYS_ASSERT(cache.numUpdates() == nupdates+1);
+    redistribute(0);
+    AMREX_ALWAYS_ASSERT(cache.numUpdates() == nupdates+2);
+    AMREX_ALWAYS_ASSERT(!cache.isNeighbor(next) && !cache.isNeighbor(prev));
+
+    amrex::Print() << "copy plan cache pass \n";
+}
@@ -0,0 +1,142 @@
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Print.H>
+#include <AMReX_Random.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VisMF.H>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+
+using namespace amrex;
+
+namespace {
+
+constexpr int ncomp = 4;
+constexpr int nghost = 1;
+
+// Component 0 is smooth, 1 is random, 2 is constant, and 3 has a NaN and an
+// infinity in the first FAB.
+void init (MultiFab& mf)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), [&] (int i, int j, int k)
+        {
+            a(i,j,k,0) = std::sin(0.1*i) * std::cos(0.07*j) + 0.01*k;
+            a(i,j,k,1) = amrex::Random() - 0.5;
+            a(i,j,k,2) = 3.25;
+            a(i,j,k,3) = 1.e10*amrex::Random();
+        });
+        if (mfi.index() == 0) {
+            auto const lo = amrex::lbound(mfi.fabbox());
+            a(lo.x,lo.y,lo.z,3) = std::numeric_limits<Real>::quiet_NaN();
+            a(lo.x+1,lo.y,lo.z,3) = std::numeric_limits<Real>::infinity();
+        }
+    }
+}
+
+MultiFab write_and_read (MultiFab const& mf, std::string const& name, Real tol)
+{
+    VisMF::SetHeaderVersion(VisMF::Header::Compressed_v1);
+    VisMF::SetCompressionTolerance(tol);
+    VisMF::Write(mf, name);
+    AMREX_ALWAYS_ASSERT(VisMF::Check(name));
+
+    MultiFab mf2(mf.boxArray(), mf.DistributionMap(), ncomp, nghost);
+    VisMF::Read(mf2, name);
+    return mf2;
+}
+
+// Every value must be bit-identical.
+void check_lossless (MultiFab const& mf, MultiFab const& mf2)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& fab = mf[mfi];
+        auto const& fab2 = mf2[mfi];
+        AMREX_ALWAYS_ASSERT(fab.box() == fab2.box());
+        AMREX_ALWAYS_ASSERT(std::memcmp(fab.dataPtr(), fab2.dataPtr(), fab.nBytes()) == 0);
+    }
+}
+
+// The error must be bounded by tol times the range of the component in
+// the FAB. Components that are not finite must be stored losslessly.
+// Returns the number of values that have changed.
+Long check_lossy (MultiFab const& mf, MultiFab const& mf2, Real tol)
+{
+    Long nchanged = 0;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& fab = mf[mfi];
+        auto const& fab2 = mf2[mfi];
+        const Box& bx = fab.box();
+        for (int n = 0; n < ncomp; ++n) {
+            bool finite = true;
+            Real lo = std::numeric_limits<Real>::max();
+            Real hi = std::numeric_limits<Real>::lowest();
+            amrex::LoopOnCpu(bx, [&] (int i, int j, int k)
+            {
+                Real v = fab(IntVect(AMREX_D_DECL(i,j,k)), n);
+                finite = finite && std::isfinite(v);
+                lo = std::min(lo, v);
+                hi = std::max(hi, v);
+            });
+            if (finite) {
+                const Real bound = tol*(hi-lo);
+                amrex::LoopOnCpu(bx, [&] (int i, int j, int k)
+                {
+                    IntVect iv(AMREX_D_DECL(i,j,k));
+                    AMREX_ALWAYS_ASSERT(std::abs(fab(iv,n)-fab2(iv,n)) <= bound);
+                    if (fab(iv,n) != fab2(iv,n)) { ++nchanged; }
+                });
+            } else {
+                AMREX_ALWAYS_ASSERT(std::memcmp(fab.dataPtr(n), fab2.dataPtr(n),
+                                                bx.numPts()*sizeof(Real)) == 0);
+            }
+        }
+    }
+    ParallelDescriptor::ReduceLongSum(nchanged);
+    return nchanged;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        Box domain(IntVect(0), IntVect(AMREX_D_DECL(63,47,31)));
+        BoxArray ba(domain);
+        ba.maxSize(16);
+        DistributionMapping dm(ba);
+        MultiFab mf(ba, dm, ncomp, nghost);
+        init(mf);
+
+        amrex::UtilCreateCleanDirectory("vismf_compressed", true);
+
+        amrex::Print() << "Testing lossless compression\n";
+        {
+            MultiFab mf2 = write_and_read(mf, "vismf_compressed/lossless", 0.0);
+            check_lossless(mf, mf2);
+
+            // A single component can be read on its own.
+            VisMF vismf("vismf_compressed/lossless");
+            for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+                FArrayBox const& fab = vismf.GetFab(mfi.index(), 1);
+                AMREX_ALWAYS_ASSERT(std::memcmp(fab.dataPtr(), mf[mfi].dataPtr(1),
+                                                fab.box().numPts()*sizeof(Real)) == 0);
+                vismf.clear(mfi.index(), 1);
+            }
+        }
+
+        for (Real tol : {Real(1.e-3), Real(1.e-6)}) {
+            amrex::Print() << "Testing lossy compression with tolerance " << tol << "\n";
+            MultiFab mf2 = write_and_read(mf, "vismf_compressed/lossy", tol);
+            AMREX_ALWAYS_ASSERT(check_lossy(mf, mf2, tol) > 0);
+        }
+
+        amrex::Print() << "All VisMF compression tests passed\n";
+    }
+    amrex::Finalize();
+}
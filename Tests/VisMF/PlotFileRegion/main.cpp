@@ -0,0 +1,122 @@
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_PlotFileUtil.H>
+#include <AMReX_Print.H>
+#include <AMReX_VisMF.H>
+
+#include <cstring>
+#include <string>
+
+using namespace amrex;
+
+namespace {
+
+constexpr int ncomp = 3;
+
+// Every value is unique.
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+Real value (int i, int j, int k, int n, int lev)
+{
+    return Real(i+1) + Real(200*(j+1)) + Real(40000*(k+1)) + Real(8000000*(n+4*lev));
+}
+
+void init (MultiFab& mf, int lev)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        ParallelFor(mfi.fabbox(), ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n)
+        {
+            a(i,j,k,n) = value(i,j,k,n,lev);
+        });
+    }
+}
+
+// Components [comp,comp+nc) of mf in box, zero where mf has no data.
+FArrayBox extract (MultiFab const& mf, Box const& box, int comp, int nc)
+{
+    FArrayBox fab(box, nc, The_Pinned_Arena());
+    fab.setVal<RunOn::Host>(0.0);
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        const Box& b = mfi.validbox() & box;
+        if (b.ok()) {
+            fab.copy<RunOn::Device>(mf[mfi], b, comp, b, 0, nc);
+        }
+    }
+    Gpu::streamSynchronize();
+    // The grids do not overlap, so adding zeros gives the values exactly.
+    ParallelDescriptor::ReduceRealSum(fab.dataPtr(), static_cast<int>(fab.size()));
+    return fab;
+}
+
+bool same (FArrayBox const& a, FArrayBox const& b)
+{
+    return a.box() == b.box() && a.nComp() == b.nComp()
+        && std::memcmp(a.dataPtr(), b.dataPtr(), a.nBytes()) == 0;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        const int nlevels = 2;
+        const IntVect ref_ratio(2);
+
+        Vector<Geometry> geom(nlevels);
+        Vector<BoxArray> ba(nlevels);
+        Box domain(IntVect(0), IntVect(AMREX_D_DECL(63,47,31)));
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,0.75,0.5)});
+        for (int lev = 0; lev < nlevels; ++lev) {
+            geom[lev].define(domain, rb, CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+            domain.refine(ref_ratio);
+        }
+        ba[0] = BoxArray(geom[0].Domain());
+        ba[0].maxSize(16);
+        ba[1] = BoxArray(BoxList(Vector<Box>{
+            Box(IntVect(AMREX_D_DECL(16,16,8)), IntVect(AMREX_D_DECL(63,47,31))),
+            Box(IntVect(AMREX_D_DECL(80,48,32)), IntVect(AMREX_D_DECL(111,79,47)))}));
+        ba[1].maxSize(16);
+
+        Vector<MultiFab> mf(nlevels);
+        for (int lev = 0; lev < nlevels; ++lev) {
+            mf[lev].define(ba[lev], DistributionMapping(ba[lev]), ncomp, 0);
+            init(mf[lev], lev);
+        }
+        const Vector<std::string> varnames{"a", "b", "c"};
+
+        // The query boxes cross grid boundaries, and the one at level 1
+        // is only partly covered by the grids.
+        const Vector<Box> query{
+            Box(IntVect(AMREX_D_DECL(5,10,3)), IntVect(AMREX_D_DECL(40,10,20))),
+            Box(IntVect(AMREX_D_DECL(40,30,10)), IntVect(AMREX_D_DECL(90,60,40)))};
+
+        for (auto vers : {VisMF::Header::Version_v1, VisMF::Header::NoFabHeader_v1,
+                          VisMF::Header::NoFabHeaderMinMax_v1, VisMF::Header::Compressed_v1})
+        {
+            const std::string name = "plt_region_v" + std::to_string(int(vers));
+            VisMF::SetHeaderVersion(vers);
+            VisMF::SetCompressionTolerance(0.0);
+            WriteMultiLevelPlotfile(name, nlevels, GetVecOfConstPtrs(mf), varnames,
+                                    geom, 0.0, Vector<int>(nlevels, 0),
+                                    Vector<IntVect>(nlevels, ref_ratio));
+
+            amrex::Print() << "Testing header version " << int(vers) << "\n";
+
+            PlotFileData pf(name);
+            for (int lev = 0; lev < nlevels; ++lev) {
+                const Box& box = query[lev];
+                for (int comp = 0; comp < ncomp; ++comp) {
+                    FArrayBox expected = extract(pf.get(lev, varnames[comp]), box, 0, 1);
+                    AMREX_ALWAYS_ASSERT(same(pf.get(lev, box, comp), expected));
+                    AMREX_ALWAYS_ASSERT(same(pf.get(lev, box, varnames[comp]), expected));
+                }
+                FArrayBox expected = extract(pf.get(lev), box, 1, 2);
+                AMREX_ALWAYS_ASSERT(same(pf.get(lev, box, 1, 2), expected));
+            }
+        }
+
+        amrex::Print() << "All PlotFileData region tests passed\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,117 @@
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VisMF.H>
+
+#include <string>
+
+using namespace amrex;
+
+namespace {
+
+constexpr int ncomp = 5;
+constexpr int nghost = 1;
+
+// Every value is unique and non-negative.
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+Real value (int i, int j, int k, int n)
+{
+    return Real(i+8) + Real(100*(j+8)) + Real(10000*(k+8)) + Real(1000000*n);
+}
+
+void init (MultiFab& mf)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        ParallelFor(mfi.fabbox(), ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n)
+        {
+            a(i,j,k,n) = value(i,j,k,n);
+        });
+    }
+}
+
+// Cells of the FABs inside region must hold components [scomp,scomp+nc),
+// and the others must still be -1. Returns the number of wrong cells.
+Long check (MultiFab const& mf, int scomp, BoxArray const& region)
+{
+    const int nc = mf.nComp();
+    Long nbad = 0;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        FArrayBox fab(mfi.fabbox(), nc, The_Pinned_Arena());
+        fab.copy<RunOn::Device>(mf[mfi]);
+        Gpu::streamSynchronize();
+        auto const& a = fab.const_array();
+        amrex::LoopOnCpu(mfi.fabbox(), nc, [&] (int i, int j, int k, int n)
+        {
+            IntVect iv(AMREX_D_DECL(i,j,k));
+            const bool inside = region.empty() || region.contains(iv);
+            const Real expected = inside ? value(i,j,k,scomp+n) : Real(-1.0);
+            if (a(i,j,k,n) != expected) { ++nbad; }
+        });
+    }
+    ParallelDescriptor::ReduceLongSum(nbad);
+    return nbad;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        Box domain(IntVect(0), IntVect(AMREX_D_DECL(63,47,31)));
+        BoxArray ba(domain);
+        ba.maxSize(16);
+        DistributionMapping dm(ba);
+        MultiFab mf(ba, dm, ncomp, nghost);
+        init(mf);
+
+        // The region covers parts of several FABs and some of their ghost
+        // cells.
+        BoxArray region(BoxList(Vector<Box>{
+            Box(IntVect(AMREX_D_DECL(10,5,3)), IntVect(AMREX_D_DECL(40,20,17))),
+            Box(IntVect(AMREX_D_DECL(50,30,20)), IntVect(AMREX_D_DECL(64,48,32)))}));
+
+        // The MultiFabs read into are distributed differently.
+        Vector<int> pmap = dm.ProcessorMap();
+        for (auto& p : pmap) { p = (p+1) % ParallelDescriptor::NProcs(); }
+        DistributionMapping dm2(std::move(pmap));
+
+        amrex::UtilCreateCleanDirectory("vismf_read_subset", true);
+
+        // One reader at a time per file exercises the throttling.
+        VisMF::SetMFFileInStreams(1);
+
+        for (auto vers : {VisMF::Header::Version_v1, VisMF::Header::NoFabHeader_v1,
+                          VisMF::Header::NoFabHeaderMinMax_v1, VisMF::Header::Compressed_v1})
+        {
+            const std::string name = "vismf_read_subset/mf" + std::to_string(int(vers));
+            VisMF::SetHeaderVersion(vers);
+            VisMF::SetCompressionTolerance(0.0);
+            VisMF::Write(mf, name);
+
+            amrex::Print() << "Testing header version " << int(vers) << "\n";
+
+            // Components only, into a MultiFab defined by Read
+            {
+                MultiFab mf2;
+                VisMF::Read(mf2, name, 1, 2);
+                AMREX_ALWAYS_ASSERT(mf2.boxArray() == ba && mf2.nComp() == 2
+                                    && mf2.nGrowVect() == IntVect(nghost));
+                AMREX_ALWAYS_ASSERT(check(mf2, 1, BoxArray()) == 0);
+            }
+
+            // Components and region
+            {
+                MultiFab mf2(ba, dm2, 3, nghost);
+                mf2.setVal(Real(-1.0));
+                VisMF::Read(mf2, name, 2, 3, region);
+                AMREX_ALWAYS_ASSERT(check(mf2, 2, region) == 0);
+            }
+        }
+
+        amrex::Print() << "All VisMF subset read tests passed\n";
+    }
+    amrex::Finalize();
+}
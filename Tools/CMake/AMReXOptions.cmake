@@ -313,6 +313,10 @@ if (AMReX_PARTICLES)
          " Must be one of ${AMReX_PARTICLES_PRECISION_VALUES}")
    endif()
    message( STATUS "   AMReX_PARTICLES_PRECISION = ${AMReX_PARTICLES_PRECISION}")
+
+   option( AMReX_PARTICLES_DENSE_TILES
+      "Store particle tiles in an index-addressed container instead of std::map" OFF )
+   print_option( AMReX_PARTICLES_DENSE_TILES )
 endif ()
 
 
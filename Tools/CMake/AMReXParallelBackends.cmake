@@ -9,6 +9,13 @@ foreach(D IN LISTS AMReX_SPACEDIM)
     target_link_libraries( amrex_${D}d PUBLIC Threads::Threads )
 endforeach()
 
+# dlopen is used by Parser::compileNative
+if (CMAKE_DL_LIBS AND AMReX_GPU_BACKEND STREQUAL NONE)
+    foreach(D IN LISTS AMReX_SPACEDIM)
+        target_link_libraries( amrex_${D}d PUBLIC ${CMAKE_DL_LIBS} )
+    endforeach()
+endif ()
+
 
 #
 #
@@ -225,12 +225,13 @@ void main_main()
             const iMultiFab mask = makeFineMask(pf.boxArray(ilev), pf.DistributionMap(ilev),
                                                 pf.boxArray(ilev+1), ratio);
             for (int ivar = 0; ivar < var_names.size(); ++ivar) {
-                const MultiFab& mf = pf.get(ilev, var_names[ivar]);
-                for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+                for (MFIter mfi(mask); mfi.isValid(); ++mfi) {
                     const Box& bx = mfi.validbox() & slice_box;
                     if (bx.ok()) {
+                        // Only the slice is read from disk.
+                        const FArrayBox slice_fab = pf.get(ilev, bx, var_names[ivar]);
                         const auto& m = mask.array(mfi);
-                        const auto& fab = mf.array(mfi);
+                        const auto& fab = slice_fab.const_array();
                         const auto lo = amrex::lbound(bx);
                         const auto hi = amrex::ubound(bx);
                         for         (int k = lo.z; k <= hi.z; ++k) {
@@ -255,11 +256,11 @@ void main_main()
             rr *= ratio;
         } else {
             for (int ivar = 0; ivar < var_names.size(); ++ivar) {
-                const MultiFab& mf = pf.get(ilev, var_names[ivar]);
-                for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+                for (MFIter mfi(pf.boxArray(ilev), pf.DistributionMap(ilev)); mfi.isValid(); ++mfi) {
                     const Box& bx = mfi.validbox() & slice_box;
                     if (bx.ok()) {
-                        const auto& fab = mf.array(mfi);
+                        const FArrayBox slice_fab = pf.get(ilev, bx, var_names[ivar]);
+                        const auto& fab = slice_fab.const_array();
                         const auto lo = amrex::lbound(bx);
                         const auto hi = amrex::ubound(bx);
                         for         (int k = lo.z; k <= hi.z; ++k) {